@@ -12,22 +12,41 @@
 #include "mednafen/general.cpp"
 #include "mednafen/FileStream.cpp"
 #include "mednafen/MemoryStream.cpp"
+#include "mednafen/MMapStream.cpp"
 #include "mednafen/Stream.cpp"
 
 #ifdef NEED_CD
 #include "mednafen/cdrom/CDAccess.cpp"
 #include "mednafen/cdrom/CDAccess_Image.cpp"
 #include "mednafen/cdrom/CDAccess_CCD.cpp"
+#include "mednafen/cdrom/CDAccess_Memory.cpp"
+#ifdef HAVE_CHD
+#include "mednafen/cdrom/CDAccess_CHD.cpp"
+#endif
+#ifdef HAVE_ZLIB
+#include "mednafen/cdrom/CDAccess_PBP.cpp"
+#endif
 #include "mednafen/cdrom/CDUtility.cpp"
 #ifdef WANT_ECC
 #include "mednafen/cdrom/lec.cpp"
 #endif
 #include "mednafen/cdrom/audioreader.cpp"
+#ifdef HAVE_FLAC
+#include "mednafen/cdrom/audioreader_flac.cpp"
+#endif
+#ifdef HAVE_WAVPACK
+#include "mednafen/cdrom/audioreader_wavpack.cpp"
+#endif
 #include "mednafen/cdrom/cdromif.cpp"
 #endif
 
 #include "mednafen/mempatcher.cpp"
 #include "mednafen/file.cpp"
 #include "mednafen/md5.cpp"
+#include "mednafen/state_rewind.cpp"
+#include "mednafen/state_hash.cpp"
+#include "mednafen/async_writer.cpp"
+#include "mednafen/movie.cpp"
+#include "mednafen/trace.cpp"
 
 #include "libretro.cpp"
@@ -18,6 +18,10 @@
 #include "mednafen/trio/trio.c"
 #include "mednafen/trio/triostr.c"
 
+#ifdef WANT_THREADING
+#include "threads.c"
+#endif
+
 #include "mednafen/mednafen-endian.c"
 #include "mednafen/state.c"
 #include "mednafen/video/Deinterlacer.c"
@@ -37,3 +41,5 @@
 #include "mednafen/psx/mdec.c"
 #include "mednafen/psx/timer.c"
 #include "mednafen/psx/gte.c"
+#include "mednafen/psx/dirty.c"
+#include "mednafen/psx/profile.c"
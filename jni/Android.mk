@@ -48,6 +48,8 @@ LOCAL_MODULE    := libretro
 	$(CORE_DIR)/spu.cpp \
 	$(CORE_DIR)/gpu.cpp \
 	$(CORE_DIR)/mdec.cpp \
+	$(CORE_DIR)/dirty.c \
+	$(CORE_DIR)/profile.c \
 	$(CORE_DIR)/input/gamepad.cpp \
 	$(CORE_DIR)/input/dualanalog.cpp \
 	$(CORE_DIR)/input/dualshock.cpp \
@@ -76,7 +78,7 @@ FLAGS += -DNEED_DEINTERLACER
 endif
 
 ifeq ($(NEED_CD), 1)
-CDROM_SOURCES := $(MEDNAFEN_DIR)/cdrom/CDAccess.cpp $(MEDNAFEN_DIR)/cdrom/CDAccess_Image.cpp $(MEDNAFEN_DIR)/cdrom/CDAccess_CCD.cpp $(MEDNAFEN_DIR)/cdrom/CDUtility.cpp $(MEDNAFEN_DIR)/cdrom/lec.cpp $(MEDNAFEN_DIR)/cdrom/SimpleFIFO.cpp $(MEDNAFEN_DIR)/cdrom/audioreader.cpp $(MEDNAFEN_DIR)/cdrom/galois.cpp $(MEDNAFEN_DIR)/cdrom/recover-raw.cpp $(MEDNAFEN_DIR)/cdrom/l-ec.cpp $(MEDNAFEN_DIR)/cdrom/cdromif.cpp $(MEDNAFEN_DIR)/cdrom/crc32.cpp
+CDROM_SOURCES := $(MEDNAFEN_DIR)/cdrom/CDAccess.cpp $(MEDNAFEN_DIR)/cdrom/CDAccess_Image.cpp $(MEDNAFEN_DIR)/cdrom/CDAccess_CCD.cpp $(MEDNAFEN_DIR)/cdrom/CDAccess_Memory.cpp $(MEDNAFEN_DIR)/cdrom/CDUtility.cpp $(MEDNAFEN_DIR)/cdrom/lec.cpp $(MEDNAFEN_DIR)/cdrom/SimpleFIFO.cpp $(MEDNAFEN_DIR)/cdrom/audioreader.cpp $(MEDNAFEN_DIR)/cdrom/galois.cpp $(MEDNAFEN_DIR)/cdrom/recover-raw.cpp $(MEDNAFEN_DIR)/cdrom/l-ec.cpp $(MEDNAFEN_DIR)/cdrom/cdromif.cpp $(MEDNAFEN_DIR)/cdrom/crc32.cpp
 FLAGS += -DNEED_CD
 endif
 
@@ -93,6 +95,7 @@ MEDNAFEN_SOURCES := $(MEDNAFEN_DIR)/error.cpp \
 	$(MEDNAFEN_DIR)/FileWrapper.cpp \
 	$(MEDNAFEN_DIR)/FileStream.cpp \
 	$(MEDNAFEN_DIR)/MemoryStream.cpp \
+	$(MEDNAFEN_DIR)/MMapStream.cpp \
 	$(MEDNAFEN_DIR)/Stream.cpp \
 	$(MEDNAFEN_DIR)/state.cpp \
 	$(MEDNAFEN_DIR)/mempatcher.cpp \
@@ -100,7 +103,12 @@ MEDNAFEN_SOURCES := $(MEDNAFEN_DIR)/error.cpp \
 	$(MEDNAFEN_DIR)/video/surface.cpp \
 	$(MEDNAFEN_DIR)/file.cpp \
 	$(MEDNAFEN_DIR)/endian.cpp \
-	$(MEDNAFEN_DIR)/md5.cpp
+	$(MEDNAFEN_DIR)/md5.cpp \
+	$(MEDNAFEN_DIR)/state_rewind.cpp \
+	$(MEDNAFEN_DIR)/state_hash.cpp \
+	$(MEDNAFEN_DIR)/async_writer.cpp \
+	$(MEDNAFEN_DIR)/movie.cpp \
+	$(MEDNAFEN_DIR)/trace.cpp
 
 
 LIBRETRO_SOURCES := $(MEDNAFEN_LIBRETRO_DIR)/libretro.cpp
@@ -4,11 +4,17 @@
 #include "mednafen/error.h"
 #include "mednafen/general.h"
 #include "mednafen/md5.h"
+#include "mednafen/state_rewind.h"
+#include "mednafen/state_hash.h"
+#include "mednafen/async_writer.h"
+#include "mednafen/movie.h"
+#include "mednafen/trace.h"
 #include "mednafen/msvc_compat.h"
 #ifdef NEED_DEINTERLACER
 #include	"mednafen/video/Deinterlacer.h"
 #endif
 #include "libretro.h"
+#include "libretro_psx_ext.h"
 
 struct retro_perf_callback perf_cb;
 retro_get_cpu_features_t perf_get_cpu_features_cb = NULL;
@@ -141,11 +147,14 @@ uint32_t PSX_GetRandU32(uint32_t mina, uint32_t maxa)
 
 static std::vector<CDIF*> *cdifs = NULL;
 static std::vector<const char *> cdifs_scex_ids;
+static unsigned cdifs_region;	// Return value of the last PSX_CalcDiscSCEx().
 static bool CD_TrayOpen;
 static int CD_SelectedDisc;     // -1 for no disc
 
 static uint64_t Memcard_PrevDC[8];
 static int64_t Memcard_SaveDelay[8];
+// What each memcard's .mcr file holds, as of the last write queued for it.
+static uint8 Memcard_Image[8][1 << 17];
 
 PS_CPU *CPU = NULL;
 
@@ -303,6 +312,14 @@ void PSX_ForceEventUpdates(const int32_t timestamp)
    CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time);
 }
 
+// Trace every PSX_EventHandler() dispatch too, see retro_psx_trace_start().
+static bool trace_events = false;
+
+static const char *const trace_event_names[PSX_EVENT__COUNT] =
+{
+   NULL, "GPU_Update", "CDC_Update", "TIMER_Update", "DMA_Update", "FrontIO_Update", NULL
+};
+
 bool MDFN_FASTCALL PSX_EventHandler(const int32_t timestamp)
 {
    event_list_entry *e = events[PSX_EVENT__SYNFIRST].next;
@@ -327,6 +344,10 @@ bool MDFN_FASTCALL PSX_EventHandler(const int32_t timestamp)
          printf("Late: %u %d --- %8d\n", e->which, timestamp - e->event_time, timestamp);
 #endif
 
+      const uint64 trace_start = trace_events ? MDFNTR_Begin() : 0;
+
+      PSX_COUNT(events[e->which], 1);
+
       switch(e->which)
       {
          default:
@@ -347,6 +368,8 @@ bool MDFN_FASTCALL PSX_EventHandler(const int32_t timestamp)
             nt = FrontIO_Update(e->event_time);
             break;
       }
+
+      MDFNTR_End(trace_event_names[e->which], trace_start);
 #if PSX_EVENT_SYSTEM_CHECKS
       assert(nt > e->event_time);
 #endif
@@ -413,6 +436,9 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(int32
 
       //DMA_CheckReadDebug(A);
       //assert(A <= 0x1FFFFF);
+      if(IsWrite)
+         PSX_DirtyMark(PSX_DIRTY_MAINRAM, A & 0x1FFFFF);
+
       if(Access24)
       {
          if(IsWrite)
@@ -923,6 +949,7 @@ static void PSX_Power(void)
    PseudoRNG_ResetState();
 
    memset(MainRAM.data32, 0, 2048 * 1024);
+   PSX_DirtyMarkAll(PSX_DIRTY_MAINRAM);
 
    for(i = 0; i < 9; i++)
       SysControl.Regs[i] = 0;
@@ -997,7 +1024,7 @@ static bool TestMagicCD(std::vector<CDIF *> *CDInterfaces)
    return(true);
 }
 
-const char *PSX_CalcDiscSCEx_BySYSTEMCNF(CDIF *c, unsigned *rr)
+const char *PSX_CalcDiscSCEx_BySYSTEMCNF(CDIF *c, unsigned *rr, char *game_id, size_t game_id_size)
 {
    const char *ret = NULL;
    Stream *fp = NULL;
@@ -1081,6 +1108,19 @@ const char *PSX_CalcDiscSCEx_BySYSTEMCNF(CDIF *c, unsigned *rr)
                bootpos += 7;
                char *tmp;
 
+               if(game_id)
+               {
+                  const char *gid = bootpos;
+                  size_t i;
+
+                  while(*gid == '\\')
+                     gid++;
+
+                  for(i = 0; i + 1 < game_id_size && gid[i] > 0x20 && gid[i] != ';'; i++)
+                     game_id[i] = gid[i];
+                  game_id[i] = 0;
+               }
+
                if((tmp = strchr(bootpos, '_'))) *tmp = 0;
                if((tmp = strchr(bootpos, '.'))) *tmp = 0;
                if((tmp = strchr(bootpos, ';'))) *tmp = 0;
@@ -1126,6 +1166,76 @@ Breakout:
    return(ret);
 }
 
+// Reads what's needed to identify the disc, once per CDIF; see CDIF_DiscIdentity.
+static const CDIF_DiscIdentity *PSX_IdentifyDisc(CDIF *c)
+{
+   CDIF_DiscIdentity *di = &c->identity;
+   unsigned region = ~0U;
+   uint8_t buf[2048];
+   uint8_t fbuf[2048 + 1];
+   unsigned ipos, opos;
+
+   if(di->valid)
+      return di;
+
+   di->game_id[0] = 0;
+   di->license_unknown = false;
+   di->scex_id = PSX_CalcDiscSCEx_BySYSTEMCNF(c, &region, di->game_id, sizeof(di->game_id));
+
+   memset(fbuf, 0, sizeof(fbuf));
+
+   if(di->scex_id == NULL && CDIF_ReadSector(c, buf, 4, 1) == 0x2)
+   {
+      for(ipos = 0, opos = 0; ipos < 0x48; ipos++)
+      {
+         if(buf[ipos] > 0x20 && buf[ipos] < 0x80)
+         {
+            fbuf[opos++] = tolower(buf[ipos]);
+         }
+      }
+
+      fbuf[opos++] = 0;
+
+      PSX_DBG(PSX_DBG_SPARSE, "License string: %s", (char *)fbuf);
+
+      if(strstr((char *)fbuf, "licensedby") != NULL)
+      {
+         if(strstr((char *)fbuf, "america") != NULL)
+         {
+            di->scex_id = "SCEA";
+            region = REGION_NA;
+         }
+         else if(strstr((char *)fbuf, "europe") != NULL)
+         {
+            di->scex_id = "SCEE";
+            region = REGION_EU;
+         }
+         else if(strstr((char *)fbuf, "japan") != NULL)
+         {
+            di->scex_id = "SCEI";	// ?
+            region = REGION_JP;
+         }
+         else if(strstr((char *)fbuf, "sonycomputerentertainmentinc.") != NULL)
+         {
+            di->scex_id = "SCEI";
+            region = REGION_JP;
+         }
+         else	// Failure case
+            di->license_unknown = true;
+      }
+   }
+
+   di->region = (region == ~0U) ? -1 : (int)region;
+   di->valid = true;
+
+   if (log_cb)
+      log_cb(RETRO_LOG_INFO, "Disc identified: %s%s%s\n", di->scex_id ? di->scex_id : "unknown",
+            di->game_id[0] ? ", " : "", di->game_id);
+
+   return di;
+}
+
+// No disc I/O after the first call for a given disc(see PSX_IdentifyDisc()).
 unsigned PSX_CalcDiscSCEx(void)
 {
    const char *prev_valid_id = NULL;
@@ -1136,77 +1246,32 @@ unsigned PSX_CalcDiscSCEx(void)
    if(cdifs)
       for(unsigned i = 0; i < cdifs->size(); i++)
       {
-         const char *id = NULL;
-         uint8_t buf[2048];
-         uint8_t fbuf[2048 + 1];
-         unsigned ipos, opos;
+         const CDIF_DiscIdentity *di = PSX_IdentifyDisc((*cdifs)[i]);
+         const char *id = di->scex_id;
 
+         // Only the first disc decides the region.
+         if(!i && di->region >= 0)
+            ret_region = di->region;
 
-         id = PSX_CalcDiscSCEx_BySYSTEMCNF((*cdifs)[i], (i == 0) ? &ret_region : NULL);
-
-         memset(fbuf, 0, sizeof(fbuf));
-
-         if(id == NULL && CDIF_ReadSector((*cdifs)[i], buf, 4, 1) == 0x2)
+         if(di->license_unknown)
          {
-            for(ipos = 0, opos = 0; ipos < 0x48; ipos++)
+            if(prev_valid_id != NULL)
+               id = prev_valid_id;
+            else
             {
-               if(buf[ipos] > 0x20 && buf[ipos] < 0x80)
+               switch(ret_region)	// Less than correct, but meh, what can we do.
                {
-                  fbuf[opos++] = tolower(buf[ipos]);
-               }
-            }
-
-            fbuf[opos++] = 0;
+                  case REGION_JP:
+                     id = "SCEI";
+                     break;
 
-            PSX_DBG(PSX_DBG_SPARSE, "License string: %s", (char *)fbuf);
+                  case REGION_NA:
+                     id = "SCEA";
+                     break;
 
-            if(strstr((char *)fbuf, "licensedby") != NULL)
-            {
-               if(strstr((char *)fbuf, "america") != NULL)
-               {
-                  id = "SCEA";
-                  if(!i)
-                     ret_region = REGION_NA;
-               }
-               else if(strstr((char *)fbuf, "europe") != NULL)
-               {
-                  id = "SCEE";
-                  if(!i)
-                     ret_region = REGION_EU;
-               }
-               else if(strstr((char *)fbuf, "japan") != NULL)
-               {
-                  id = "SCEI";	// ?
-                  if(!i)
-                     ret_region = REGION_JP;
-               }
-               else if(strstr((char *)fbuf, "sonycomputerentertainmentinc.") != NULL)
-               {
-                  id = "SCEI";
-                  if(!i)
-                     ret_region = REGION_JP;
-               }
-               else	// Failure case
-               {
-                  if(prev_valid_id != NULL)
-                     id = prev_valid_id;
-                  else
-                  {
-                     switch(ret_region)	// Less than correct, but meh, what can we do.
-                     {
-                        case REGION_JP:
-                           id = "SCEI";
-                           break;
-
-                        case REGION_NA:
-                           id = "SCEA";
-                           break;
-
-                        case REGION_EU:
-                           id = "SCEE";
-                           break;
-                     }
-                  }
+                  case REGION_EU:
+                     id = "SCEE";
+                     break;
                }
             }
          }
@@ -1217,6 +1282,8 @@ unsigned PSX_CalcDiscSCEx(void)
          cdifs_scex_ids.push_back(id);
       }
 
+   cdifs_region = ret_region;
+
    return ret_region;
 }
 
@@ -1363,6 +1430,7 @@ static void InitCommon(std::vector<CDIF *> *CDInterfaces, const bool EmulateMemc
       char ext[64];
       snprintf(ext, sizeof(ext), "%d.mcr", i);
       FrontIO_LoadMemcard(i, MDFN_MakeFName(MDFNMKF_SAV, 0, ext).c_str());
+      FrontIO_TakeMemcardChanges(i, Memcard_Image[i], true);
    }
 
    for(i = 0; i < 8; i++)
@@ -1615,6 +1683,20 @@ static void Cleanup(void)
    cdifs = NULL;
 }
 
+// Queues memcard "which" to be written to its .mcr file if it changed since the last write.
+// Only the changed frames are copied out of the card; the file itself is written and
+// swapped in by the background writer(mednafen/async_writer.h).
+static void Memcard_Flush(int which)
+{
+   char ext[64];
+
+   if (!FrontIO_TakeMemcardChanges(which, Memcard_Image[which], false))
+      return;
+
+   snprintf(ext, sizeof(ext), "%d.mcr", which);
+   MDFNAW_Write(MDFN_MakeFName(MDFNMKF_SAV, 0, ext).c_str(), Memcard_Image[which], 1 << 17);
+}
+
 static void CloseGame(void)
 {
    int i;
@@ -1630,10 +1712,7 @@ static void CloseGame(void)
       // we can reduce potential data loss!
       try
       {
-         char ext[64];
-         snprintf(ext, sizeof(ext), "%d.mcr", i);
-
-         FrontIO_SaveMemcard(i, MDFN_MakeFName(MDFNMKF_SAV, 0, ext).c_str());
+         Memcard_Flush(i);
       }
       catch(std::exception &e)
       {
@@ -1642,6 +1721,9 @@ static void CloseGame(void)
       }
    }
 
+   // Everything has to be on disk before the game goes away.
+   MDFNAW_Kill();
+
    Cleanup();
 }
 
@@ -1663,7 +1745,7 @@ static int StateAction(StateMem *sm, int load, int data_only)
    {
       { &((CD_TrayOpen)), 1, 0x80000000 | 0x08000000, "CD_TrayOpen" },
       { &((CD_SelectedDisc)), sizeof((CD_SelectedDisc)), 0x80000000 | 0, "CD_SelectedDisc" },
-      { ((MainRAM.data8)), (uint32)((1024 * 2048)), 0 | 0, "MainRAM.data8" },
+      { ((MainRAM.data8)), (uint32)((1024 * 2048)), 0 | MDFNSTATE_TRACKED | PSX_DIRTY_MAINRAM, "MainRAM.data8" },
       { ((SysControl.Regs)), (uint32)(((9)) * sizeof(uint32)), 0x40000000 | 0, "SysControl.Regs" },
       { &((PSX_PRNG.lcgo)), sizeof((PSX_PRNG.lcgo)), 0x80000000 | 0, "PSX_PRNG.lcgo" },
       { &((PSX_PRNG.x)), sizeof((PSX_PRNG.x)), 0x80000000 | 0, "PSX_PRNG.x" },
@@ -1703,7 +1785,17 @@ static int StateAction(StateMem *sm, int load, int data_only)
    ret &= IRQ_StateAction(sm, load, data_only);	// Do it last.
 
    if(load)
+   {
+      // A tracked state(run-ahead's fork) only puts back pages that were marked when they were written after it.
+      if(!sm->tracked)
+      {
+         PSX_DirtyMarkAll(PSX_DIRTY_MAINRAM);
+         PSX_DirtyMarkAll(PSX_DIRTY_GPURAM);
+         PSX_DirtyMarkAll(PSX_DIRTY_SPURAM);
+      }
+
       PSX_ForceEventUpdates(0); // FIXME to work with debugger step mode.
+   }
 
    return(ret);
 }
@@ -1951,7 +2043,17 @@ static bool PrevInterlaced;
 #define MEDNAFEN_CORE_NAME_MODULE "psx"
 #define MEDNAFEN_CORE_NAME "Beetle PSX"
 #define MEDNAFEN_CORE_VERSION "v0.9.36.5"
-#define MEDNAFEN_CORE_EXTENSIONS "cue|toc|ccd|m3u"
+#ifdef HAVE_CHD
+#define MEDNAFEN_CORE_EXTENSIONS_CHD "|chd"
+#else
+#define MEDNAFEN_CORE_EXTENSIONS_CHD ""
+#endif
+#ifdef HAVE_ZLIB
+#define MEDNAFEN_CORE_EXTENSIONS_PBP "|pbp"
+#else
+#define MEDNAFEN_CORE_EXTENSIONS_PBP ""
+#endif
+#define MEDNAFEN_CORE_EXTENSIONS "cue|toc|ccd|m3u" MEDNAFEN_CORE_EXTENSIONS_CHD MEDNAFEN_CORE_EXTENSIONS_PBP
 #define MEDNAFEN_CORE_GEOMETRY_BASE_W 320
 #define MEDNAFEN_CORE_GEOMETRY_BASE_H 240
 #define MEDNAFEN_CORE_GEOMETRY_MAX_W 700
@@ -1980,6 +2082,7 @@ static bool disk_set_eject_state(bool ejected)
 
    DoSimpleCommand(ejected ? MDFN_MSC_EJECT_DISK : MDFN_MSC_INSERT_DISK);
    eject_state = ejected;
+   MDFNMOV_RecordEvent(MDFNMOV_EVENT_EJECT, ejected);
    return true;
 }
 
@@ -2004,6 +2107,7 @@ static bool disk_set_image_index(unsigned index)
    CD_SelectedDisc--;
 
    DoSimpleCommand(MDFN_MSC_SELECT_DISK);
+   MDFNMOV_RecordEvent(MDFNMOV_EVENT_SELECT_DISC, index);
    return true;
 }
 
@@ -2011,27 +2115,30 @@ static bool disk_set_image_index(unsigned index)
 // Hack around this.
 static void update_md5_checksum(CDIF *iface)
 {
-   uint8 LayoutMD5[16];
-   md5_context layout_md5;
+   if (!iface->identity.md5_valid)
+   {
+      md5_context layout_md5;
+      CD_TOC toc;
 
-   layout_md5.starts();
+      layout_md5.starts();
 
-   CD_TOC toc;
+      CDIF_ReadTOC(iface, &toc);
 
-   CDIF_ReadTOC(iface, &toc);
+      layout_md5.update_u32_as_lsb(toc.first_track);
+      layout_md5.update_u32_as_lsb(toc.last_track);
+      layout_md5.update_u32_as_lsb(toc.tracks[100].lba);
 
-   layout_md5.update_u32_as_lsb(toc.first_track);
-   layout_md5.update_u32_as_lsb(toc.last_track);
-   layout_md5.update_u32_as_lsb(toc.tracks[100].lba);
+      for (uint32 track = toc.first_track; track <= toc.last_track; track++)
+      {
+         layout_md5.update_u32_as_lsb(toc.tracks[track].lba);
+         layout_md5.update_u32_as_lsb(toc.tracks[track].control & 0x4);
+      }
 
-   for (uint32 track = toc.first_track; track <= toc.last_track; track++)
-   {
-      layout_md5.update_u32_as_lsb(toc.tracks[track].lba);
-      layout_md5.update_u32_as_lsb(toc.tracks[track].control & 0x4);
+      layout_md5.finish(iface->identity.layout_md5);
+      iface->identity.md5_valid = true;
    }
 
-   layout_md5.finish(LayoutMD5);
-   memcpy(MDFNGameInfo->MD5, LayoutMD5, 16);
+   memcpy(MDFNGameInfo->MD5, iface->identity.layout_md5, 16);
    
    std::string md5 = md5_context::asciistr(MDFNGameInfo->MD5, 0);
    if (log_cb)
@@ -2049,7 +2156,7 @@ static bool disk_replace_image_index(unsigned index, const struct retro_game_inf
 
    if (!info)
    {
-      delete cdifs->at(index);
+      CDIF_Free(cdifs->at(index));
       cdifs->erase(cdifs->begin() + index);
       if (index < CD_SelectedDisc)
          CD_SelectedDisc--;
@@ -2059,20 +2166,39 @@ static bool disk_replace_image_index(unsigned index, const struct retro_game_inf
       return true;
    }
 
+   // A multi-disc image(PBP) expands into consecutive slots, as when it's loaded as the game:
+   // its first disc replaces slot "index" and the others are inserted right after it, in
+   // order, so the frontend sees the image count grow by the extra discs.
+   std::vector<CDIF *> discs;
+
    try
    {
-      CDIF *iface = CDIF_Open(info->path, false, false);
-      delete cdifs->at(index);
-      cdifs->at(index) = iface;
-      PSX_CalcDiscSCEx();
-      set_basename(info->path); // If we replace, we want the "swap disk manually effect".
-      update_md5_checksum(iface); // Ugly, but needed to get proper disk swapping effect.
-      return true;
+      const bool image_memcache = MDFN_GetSettingB("libretro.cd_load_into_ram");
+      const unsigned disc_count = CDIF_GetDiscCount(info->path);
+
+      for (unsigned disc = 0; disc < disc_count; disc++)
+         discs.push_back(CDIF_Open(info->path, false, image_memcache, disc));
    }
    catch (const std::exception &e)
    {
+      for (unsigned disc = 0; disc < discs.size(); disc++)
+         CDIF_Free(discs[disc]);
       return false;
    }
+
+   if (discs.empty())
+      return false;
+
+   CDIF_Free(cdifs->at(index));
+   cdifs->at(index) = discs[0];
+   cdifs->insert(cdifs->begin() + index + 1, discs.begin() + 1, discs.end());
+   if ((int)index < CD_SelectedDisc)
+      CD_SelectedDisc += discs.size() - 1;
+
+   PSX_CalcDiscSCEx();
+   set_basename(info->path); // If we replace, we want the "swap disk manually effect".
+   update_md5_checksum(discs[0]); // Ugly, but needed to get proper disk swapping effect.
+   return true;
 }
 
 static bool disk_add_image_index(void)
@@ -2173,6 +2299,8 @@ void retro_init(void)
 void retro_reset(void)
 {
    DoSimpleCommand(MDFN_MSC_RESET);
+   MDFNSRW_Clear();
+   MDFNMOV_RecordEvent(MDFNMOV_EVENT_RESET, 0);
 }
 
 bool retro_load_game_special(unsigned, const struct retro_game_info *, size_t)
@@ -2186,6 +2314,37 @@ static bool boot = true;
 static bool experimental_savestates = false;
 static bool experimental_savestates_toggle = false;
 
+// fixed-layout savestates for run-ahead/rewind, see MDFNSS_SaveSMFast()
+static bool fast_savestates = false;
+
+// built-in rewind, see mednafen/state_rewind.h
+static bool rewind_enabled = false;
+static unsigned rewind_granularity = 2;
+static uint64 rewind_budget = (uint64)256 << 20;
+static bool rewind_active = false;
+
+// run-ahead, see RunAhead()
+static unsigned run_ahead_frames = 0;
+static StateMem run_ahead_state;
+static uint8 *run_ahead_ram[PSX_DIRTY_REGION_COUNT];
+
+static void RunAhead_Kill(void)
+{
+   free(run_ahead_state.data);
+   memset(&run_ahead_state, 0, sizeof(run_ahead_state));
+
+   for (unsigned region = 0; region < PSX_DIRTY_REGION_COUNT; region++)
+   {
+      PSX_DirtyEnable(region, PSX_DIRTY_USER_RUN_AHEAD, false);
+      free(run_ahead_ram[region]);
+      run_ahead_ram[region] = NULL;
+   }
+}
+
+// timeline trace core option: 0 = off, 1 = frame phases, 2 = frame phases and events
+static unsigned trace_option = 0;
+static bool trace_option_changed = false;
+
 // shared memory cards support
 static bool shared_memorycards = false;
 static bool shared_memorycards_toggle = false;
@@ -2200,6 +2359,10 @@ const char *msgs[] = {"SHARED MEMCARDS: restart required",
 static bool print_messages[] = {false,false,false,false,false};
 static bool pending_messages = false;
 
+// audio health stats
+static bool audio_stats_timing = false;
+static bool audio_stats_log = false;
+
 static void check_variables(void)
 {
    struct retro_variable var = {0};
@@ -2321,6 +2484,52 @@ static void check_variables(void)
          players = 2;      
    }
    
+   var.key = "beetle_psx_cd_load_into_ram";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "enabled") == 0)
+         setting_cd_load_into_ram = true;
+      else if (strcmp(var.value, "disabled") == 0)
+         setting_cd_load_into_ram = false;
+   }
+
+#ifdef HAVE_CHD
+   var.key = "beetle_psx_chd_hunk_cache";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      setting_cdrom_chd_hunk_cache = atoi(var.value);
+   }
+#endif
+
+   var.key = "beetle_psx_audio_stats";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "disabled") == 0)
+      {
+         audio_stats_timing = false;
+         audio_stats_log = false;
+      }
+      else if (strcmp(var.value, "enabled") == 0)
+      {
+         audio_stats_timing = true;
+         audio_stats_log = false;
+      }
+      else if (strcmp(var.value, "log") == 0)
+      {
+         audio_stats_timing = true;
+         audio_stats_log = true;
+      }
+   }
+
+   // Timing needs both of the frontend's perf counters.
+   if (!perf_cb.get_perf_counter || !perf_cb.get_time_usec)
+      audio_stats_timing = false;
+
+   SPU_SetStatsTiming(audio_stats_timing);
+
    var.key = "beetle_psx_use_mednafen_memcard0_method";
 
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
@@ -2413,6 +2622,72 @@ static void check_variables(void)
       }
    }
    
+   var.key = "beetle_psx_savestate_format";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "fast") == 0)
+         fast_savestates = true;
+      else if (strcmp(var.value, "portable") == 0)
+         fast_savestates = false;
+   }
+   else
+      fast_savestates = false;
+
+   var.key = "beetle_psx_rewind";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      rewind_enabled = (strcmp(var.value, "enabled") == 0);
+   else
+      rewind_enabled = false;
+
+   var.key = "beetle_psx_rewind_granularity";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      rewind_granularity = atoi(var.value);
+   else
+      rewind_granularity = 2;
+
+   var.key = "beetle_psx_rewind_buffer_size";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      rewind_budget = (uint64)atoi(var.value) << 20;
+   else
+      rewind_budget = (uint64)256 << 20;
+
+   MDFNSRW_Configure(rewind_enabled, rewind_granularity, rewind_budget);
+
+   var.key = "beetle_psx_run_ahead";
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      run_ahead_frames = atoi(var.value);
+   else
+      run_ahead_frames = 0;
+
+   if (!run_ahead_frames)
+      RunAhead_Kill();
+
+   var.key = "beetle_psx_trace";
+
+   {
+      unsigned new_trace_option = 0;
+
+      if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      {
+         if (!strcmp(var.value, "frame phases"))
+            new_trace_option = 1;
+         else if (!strcmp(var.value, "frame phases and events"))
+            new_trace_option = 2;
+      }
+
+      // Applied by retro_run(), once the game is loaded.
+      if (new_trace_option != trace_option)
+      {
+         trace_option = new_trace_option;
+         trace_option_changed = true;
+      }
+   }
+
    if(print_messages[0] || print_messages[1] || print_messages[2] || print_messages[3] || print_messages[4])
       pending_messages = true;
    else
@@ -2471,6 +2746,17 @@ end:
 
 #ifdef NEED_CD
 static std::vector<CDIF *> CDInterfaces;	// FIXME: Cleanup on error out.
+
+// Opens every disc in the image at "path"(multi-disc PBPs hold more than one) and adds them to CDInterfaces,
+// where the disk control interface can switch between them.
+static void OpenCDImage(const char *path)
+{
+   const bool image_memcache = MDFN_GetSettingB("libretro.cd_load_into_ram");
+   const unsigned disc_count = CDIF_GetDiscCount(path);
+
+   for (unsigned i = 0; i < disc_count; i++)
+      CDInterfaces.push_back(CDIF_Open(path, false, image_memcache, i));
+}
 #endif
 // TODO: LoadCommon()
 
@@ -2491,12 +2777,12 @@ MDFNGI *MDFNI_LoadCD(const char *force_module, const char *devicename)
 
    for(unsigned i = 0; i < file_list.size(); i++)
    {
-    CDInterfaces.push_back(CDIF_Open(file_list[i].c_str(), false, false));
+    OpenCDImage(file_list[i].c_str());
    }
   }
   else
   {
-   CDInterfaces.push_back(CDIF_Open(devicename, false, false));
+   OpenCDImage(devicename);
   }
  }
  catch(std::exception &e)
@@ -2565,7 +2851,7 @@ MDFNGI *MDFNI_LoadCD(const char *force_module, const char *devicename)
   for(unsigned i = 0; i < CDInterfaces.size(); i++)
   {
      if (CDInterfaces[i])
-        free(CDInterfaces[i]);
+        CDIF_Free(CDInterfaces[i]);
   }
   CDInterfaces.clear();
 
@@ -2588,7 +2874,14 @@ static MDFNGI *MDFNI_LoadGame(const char *force_module, const char *name)
 	std::vector<FileExtensionSpecStruct> valid_iae;
 
 #ifdef NEED_CD
-	if(strlen(name) > 4 && (!strcasecmp(name + strlen(name) - 4, ".cue") || !strcasecmp(name + strlen(name) - 4, ".ccd") || !strcasecmp(name + strlen(name) - 4, ".toc") || !strcasecmp(name + strlen(name) - 4, ".m3u")))
+	if(strlen(name) > 4 && (!strcasecmp(name + strlen(name) - 4, ".cue") || !strcasecmp(name + strlen(name) - 4, ".ccd") || !strcasecmp(name + strlen(name) - 4, ".toc") || !strcasecmp(name + strlen(name) - 4, ".m3u")
+#ifdef HAVE_CHD
+	 || !strcasecmp(name + strlen(name) - 4, ".chd")
+#endif
+#ifdef HAVE_ZLIB
+	 || !strcasecmp(name + strlen(name) - 4, ".pbp")
+#endif
+	 ))
 	 return(MDFNI_LoadCD(force_module, name));
 #endif
 
@@ -2649,102 +2942,356 @@ static MDFNGI *MDFNI_LoadGame(const char *force_module, const char *name)
    return(MDFNGameInfo);
 }
 
-#define MAX_PLAYERS 8
-#define MAX_BUTTONS 16
+static struct retro_psx_audio_stats audio_stats;
+static struct retro_psx_audio_stats audio_stats_window;   // Since the last periodic log line.
 
-union
-{
-   uint32_t u32[MAX_PLAYERS][1 + 8 + 1]; // Buttons + Axes + Rumble
-   uint8_t u8[MAX_PLAYERS][(1 + 8 + 1) * sizeof(uint32_t)];
-} static buf;
+#define AUDIO_STATS_LOG_INTERVAL 600
 
-static uint16_t input_buf[MAX_PLAYERS] = {0};
+static void audio_stats_reset(struct retro_psx_audio_stats *stats)
+{
+   memset(stats, 0, sizeof(*stats));
+   stats->samples_min = ~0U;
+}
 
-bool retro_load_game(const struct retro_game_info *info)
+static void audio_stats_accumulate(struct retro_psx_audio_stats *stats, const SPU_Stats *spu, uint64_t spu_usec)
 {
-   if (failed_init)
-      return false;
+   stats->frames++;
+   stats->samples = spu->SamplesProduced;
+   stats->samples_min = std::min<uint32_t>(stats->samples_min, spu->SamplesProduced);
+   stats->samples_max = std::max<uint32_t>(stats->samples_max, spu->SamplesProduced);
 
-#ifdef WANT_32BPP
-   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_XRGB8888;
-   if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+   if (spu->SamplesDropped)
    {
-      if (log_cb)
-         log_cb(RETRO_LOG_ERROR, "Pixel format XRGB8888 not supported by platform, cannot use %s.\n", MEDNAFEN_CORE_NAME);
-      return false;
+      stats->overflow_frames++;
+      stats->samples_dropped += spu->SamplesDropped;
    }
-#endif
 
-   overscan = false;
-   environ_cb(RETRO_ENVIRONMENT_GET_OVERSCAN, &overscan);
+   stats->active_voices = spu->PeakActiveVoices;
+   stats->spu_time_usec = spu_usec;
+   stats->spu_time_usec_total += spu_usec;
+}
 
-   set_basename(info->path);
+// frame_ticks/frame_usec calibrate the frontend's perf counter, whose tick rate is unspecified.
+static void update_audio_stats(const SPU_Stats *spu, retro_perf_tick_t frame_ticks, retro_time_t frame_usec)
+{
+   uint64_t spu_usec = 0;
 
-   check_variables();
-   //make sure shared memory cards and save states are enabled only at startup
-   shared_memorycards = shared_memorycards_toggle;
-   experimental_savestates = experimental_savestates_toggle;
+   if (audio_stats_timing && frame_ticks > 0)
+      spu_usec = (uint64_t)((double)spu->HostTicks * frame_usec / frame_ticks);
 
-   
-   if (environ_cb(RETRO_ENVIRONMENT_GET_RUMBLE_INTERFACE, &rumble) && log_cb)
-      log_cb(RETRO_LOG_INFO, "Rumble interface supported!\n");
+   audio_stats_accumulate(&audio_stats, spu, spu_usec);
 
-   if (!MDFNI_LoadGame(MEDNAFEN_CORE_NAME_MODULE, info->path))
-      return false;
+   if (!audio_stats_log || !log_cb)
+      return;
 
-   surf = (MDFN_Surface*)MDFN_Surface_New(NULL, MEDNAFEN_CORE_GEOMETRY_MAX_W, (PSX_CalcDiscSCEx() == REGION_EU) ? MEDNAFEN_CORE_GEOMETRY_MAX_H  : 480, MEDNAFEN_CORE_GEOMETRY_MAX_W);
+   audio_stats_accumulate(&audio_stats_window, spu, spu_usec);
 
-#ifdef NEED_DEINTERLACER
-	PrevInterlaced = false;
-	Deinterlacer_ClearState();
-#endif
+   if (spu->SamplesDropped)
+      log_cb(RETRO_LOG_WARN, "[%s]: Audio buffer full, dropped %u samples this frame.\n",
+            MEDNAFEN_CORE_NAME, spu->SamplesDropped);
 
-   //SetInput(0, "gamepad", &input_buf[0]);
-   //SetInput(1, "gamepad", &input_buf[1]);
-   
-   for (unsigned i = 0; i < players; i++)
+   if (audio_stats_window.frames >= AUDIO_STATS_LOG_INTERVAL)
    {
-       SetInput(i, "gamepad", &input_buf[i]);
+      log_cb(RETRO_LOG_INFO, "[%s]: Audio: %u-%u samples/frame, %llu overflow frames (%llu samples dropped), SPU %.1f us/frame.\n",
+            MEDNAFEN_CORE_NAME, audio_stats_window.samples_min, audio_stats_window.samples_max,
+            (unsigned long long)audio_stats_window.overflow_frames, (unsigned long long)audio_stats_window.samples_dropped,
+            (double)audio_stats_window.spu_time_usec_total / audio_stats_window.frames);
+      audio_stats_reset(&audio_stats_window);
    }
-   boot = false;
-   return true;
 }
 
-void retro_unload_game(void)
+void retro_psx_get_audio_stats(struct retro_psx_audio_stats *stats, bool reset)
 {
-   if(!MDFNGameInfo)
-      return;
+   *stats = audio_stats;
 
-   MDFN_FlushGameCheats(0);
+   if (reset)
+      audio_stats_reset(&audio_stats);
+}
 
-   MDFNGameInfo->CloseGame();
+void retro_psx_set_rewind(bool active)
+{
+   rewind_active = active;
+}
 
-   if(MDFNGameInfo->name)
-      free(MDFNGameInfo->name);
-   MDFNGameInfo->name = NULL;
+void retro_psx_get_rewind_stats(struct retro_psx_rewind_stats *stats)
+{
+   uint32 snapshots;
+   uint64 bytes;
 
-   MDFNMP_Kill();
+   MDFNSRW_GetStats(&snapshots, &bytes);
 
-   MDFNGameInfo = NULL;
+   stats->snapshots           = snapshots;
+   stats->frames_per_snapshot = rewind_enabled ? rewind_granularity : 0;
+   stats->bytes_used          = bytes;
+   stats->bytes_budget        = rewind_enabled ? rewind_budget : 0;
+}
 
-#ifdef NEED_CD
-   for(unsigned i = 0; i < CDInterfaces.size(); i++)
-   {
-      if (CDInterfaces[i])
-         free(CDInterfaces[i]);
-   }
-   CDInterfaces.clear();
+#ifdef PSX_PROFILE
+// Hot-path counters of the last retro_run(), see mednafen/psx/profile.h.
+static PSX_Counters counters_frame;
 #endif
+
+bool retro_psx_trace_start(const char *path, bool events)
+{
+   trace_events = false;
+
+   if (!MDFNTR_Start(path))
+      return false;
+
+   trace_events = events;
+   return true;
 }
 
+void retro_psx_trace_stop(void)
+{
+   MDFNTR_Stop();
+   trace_events = false;
+}
 
-// Hardcoded for PSX. No reason to parse lots of structures ...
-// See mednafen/psx/input/gamepad.cpp
-static void update_input(void)
+bool retro_psx_get_counters(struct retro_psx_counters *counters)
 {
-   //input_buf[0] = 0;
-   //input_buf[1] = 0;
-   
+   memset(counters, 0, sizeof(*counters));
+
+#ifdef PSX_PROFILE
+   const PSX_Counters *c = &counters_frame;
+
+   counters->cpu_instructions  = c->cpu_instructions;
+   counters->cpu_icache_misses = c->cpu_icache_misses;
+
+   for (unsigned i = 0; i < 256; i++)
+      counters->gpu_commands[i] = c->gpu_commands[i];
+   counters->gpu_pixels = c->gpu_pixels;
+
+   for (unsigned i = 0; i < 7; i++)
+      counters->dma_words[i] = c->dma_words[i];
+
+   counters->spu_samples       = c->spu_samples;
+   counters->spu_voice_samples = c->spu_voice_samples;
+   counters->cd_sectors        = c->cd_sectors;
+   counters->cd_xa_sectors     = c->cd_xa_sectors;
+
+   counters->events_gpu   = c->events[PSX_EVENT_GPU];
+   counters->events_cdc   = c->events[PSX_EVENT_CDC];
+   counters->events_timer = c->events[PSX_EVENT_TIMER];
+   counters->events_dma   = c->events[PSX_EVENT_DMA];
+   counters->events_fio   = c->events[PSX_EVENT_FIO];
+
+   return true;
+#else
+   return false;
+#endif
+}
+
+void retro_psx_dirty_enable(enum retro_psx_memory_region region, bool enable)
+{
+   if ((unsigned)region < PSX_DIRTY_REGION_COUNT)
+      PSX_DirtyEnable(region, PSX_DIRTY_USER_FRONTEND, enable);
+}
+
+unsigned retro_psx_dirty_page_count(enum retro_psx_memory_region region)
+{
+   if ((unsigned)region >= PSX_DIRTY_REGION_COUNT)
+      return 0;
+
+   return PSX_DirtyPageCount(region);
+}
+
+unsigned retro_psx_dirty_get(enum retro_psx_memory_region region, uint8_t *bitmap, bool reset)
+{
+   if ((unsigned)region >= PSX_DIRTY_REGION_COUNT)
+      return 0;
+
+   return PSX_DirtyGet(region, PSX_DIRTY_USER_FRONTEND, bitmap, reset);
+}
+
+uint64_t retro_psx_state_hash(bool full)
+{
+   return MDFNSH_Hash(full);
+}
+
+unsigned retro_psx_state_hash_sections(struct retro_psx_state_hash_section *sections, unsigned max)
+{
+   const MDFNSH_Section *ours;
+   unsigned count = MDFNSH_GetSections(&ours);
+
+   for (unsigned i = 0; i < count && i < max; i++)
+   {
+      memcpy(sections[i].name, ours[i].name, sizeof(sections[i].name));
+      sections[i].hash = ours[i].hash;
+   }
+
+   return count;
+}
+
+unsigned retro_psx_state_hash_compare(const struct retro_psx_state_hash_section *sections, unsigned count)
+{
+   const MDFNSH_Section *ours;
+   unsigned our_count = MDFNSH_GetSections(&ours);
+   unsigned diverged  = 0;
+
+   for (unsigned i = 0; i < our_count; i++)
+   {
+      const struct retro_psx_state_hash_section *theirs = NULL;
+
+      for (unsigned j = 0; j < count; j++)
+      {
+         if (!strncmp(sections[j].name, ours[i].name, sizeof(ours[i].name)))
+         {
+            theirs = &sections[j];
+            break;
+         }
+      }
+
+      if (theirs && theirs->hash == ours[i].hash)
+         continue;
+
+      diverged++;
+
+      if (!log_cb)
+         continue;
+
+      if (theirs)
+         log_cb(RETRO_LOG_WARN, "[%s]: State section %.32s diverged: %016llx, expected %016llx.\n",
+               MEDNAFEN_CORE_NAME, ours[i].name, (unsigned long long)ours[i].hash, (unsigned long long)theirs->hash);
+      else
+         log_cb(RETRO_LOG_WARN, "[%s]: State section %.32s is missing from the other run.\n",
+               MEDNAFEN_CORE_NAME, ours[i].name);
+   }
+
+   for (unsigned j = 0; j < count; j++)
+   {
+      bool found = false;
+
+      for (unsigned i = 0; i < our_count && !found; i++)
+         found = !strncmp(sections[j].name, ours[i].name, sizeof(ours[i].name));
+
+      if (found)
+         continue;
+
+      diverged++;
+
+      if (log_cb)
+         log_cb(RETRO_LOG_WARN, "[%s]: State section %.32s exists only in the other run.\n",
+               MEDNAFEN_CORE_NAME, sections[j].name);
+   }
+
+   return diverged;
+}
+
+#define MAX_PLAYERS 8
+#define MAX_BUTTONS 16
+
+union
+{
+   uint32_t u32[MAX_PLAYERS][1 + 8 + 1]; // Buttons + Axes + Rumble
+   uint8_t u8[MAX_PLAYERS][(1 + 8 + 1) * sizeof(uint32_t)];
+} static buf;
+
+static uint16_t input_buf[MAX_PLAYERS] = {0};
+
+// Device type of each port, as last set by retro_set_controller_port_device().
+static unsigned input_device[MAX_PLAYERS] = {
+   RETRO_DEVICE_JOYPAD, RETRO_DEVICE_JOYPAD, RETRO_DEVICE_JOYPAD, RETRO_DEVICE_JOYPAD,
+   RETRO_DEVICE_JOYPAD, RETRO_DEVICE_JOYPAD, RETRO_DEVICE_JOYPAD, RETRO_DEVICE_JOYPAD,
+};
+
+bool retro_load_game(const struct retro_game_info *info)
+{
+   if (failed_init)
+      return false;
+
+#ifdef WANT_32BPP
+   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+   if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+   {
+      if (log_cb)
+         log_cb(RETRO_LOG_ERROR, "Pixel format XRGB8888 not supported by platform, cannot use %s.\n", MEDNAFEN_CORE_NAME);
+      return false;
+   }
+#endif
+
+   overscan = false;
+   environ_cb(RETRO_ENVIRONMENT_GET_OVERSCAN, &overscan);
+
+   set_basename(info->path);
+
+   check_variables();
+   //make sure shared memory cards and save states are enabled only at startup
+   shared_memorycards = shared_memorycards_toggle;
+   experimental_savestates = experimental_savestates_toggle;
+
+   
+   if (environ_cb(RETRO_ENVIRONMENT_GET_RUMBLE_INTERFACE, &rumble) && log_cb)
+      log_cb(RETRO_LOG_INFO, "Rumble interface supported!\n");
+
+   if (!MDFNI_LoadGame(MEDNAFEN_CORE_NAME_MODULE, info->path))
+      return false;
+
+   surf = (MDFN_Surface*)MDFN_Surface_New(NULL, MEDNAFEN_CORE_GEOMETRY_MAX_W, (PSX_CalcDiscSCEx() == REGION_EU) ? MEDNAFEN_CORE_GEOMETRY_MAX_H  : 480, MEDNAFEN_CORE_GEOMETRY_MAX_W);
+
+#ifdef NEED_DEINTERLACER
+	PrevInterlaced = false;
+	Deinterlacer_ClearState();
+#endif
+
+   //SetInput(0, "gamepad", &input_buf[0]);
+   //SetInput(1, "gamepad", &input_buf[1]);
+   
+   for (unsigned i = 0; i < players; i++)
+   {
+       SetInput(i, "gamepad", &input_buf[i]);
+   }
+
+   audio_stats_reset(&audio_stats);
+   audio_stats_reset(&audio_stats_window);
+
+   boot = false;
+   return true;
+}
+
+void retro_unload_game(void)
+{
+   if(!MDFNGameInfo)
+      return;
+
+   MDFN_FlushGameCheats(0);
+
+   MDFNGameInfo->CloseGame();
+
+   if(MDFNGameInfo->name)
+      free(MDFNGameInfo->name);
+   MDFNGameInfo->name = NULL;
+
+   MDFNMP_Kill();
+
+   MDFNGameInfo = NULL;
+
+   MDFNMOV_Stop();
+   MDFNTR_Stop();
+   trace_events = false;
+   MDFNSRW_Kill();
+   MDFNSH_Kill();
+
+   RunAhead_Kill();
+
+#ifdef NEED_CD
+   for(unsigned i = 0; i < CDInterfaces.size(); i++)
+   {
+      if (CDInterfaces[i])
+         CDIF_Free(CDInterfaces[i]);
+   }
+   CDInterfaces.clear();
+#endif
+}
+
+
+// Hardcoded for PSX. No reason to parse lots of structures ...
+// See mednafen/psx/input/gamepad.cpp
+static void update_input(void)
+{
+   //input_buf[0] = 0;
+   //input_buf[1] = 0;
+   
    for (unsigned j = 0; j < players; j++)
    {
        input_buf[j] = 0;
@@ -2843,12 +3390,251 @@ static void update_input(void)
 static uint64_t video_frames, audio_frames;
 #define SOUND_CHANNELS 2
 
+static void RunFrame(EmulateSpecStruct *espec)
+{
+   /* start of Emulate */
+   int32_t timestamp = 0;
+   uint64 trace_start;
+
+   espec->LineWidths[0] = ~0;
+   MDFNGameInfo->mouse_sensitivity = MDFN_GetSettingF("psx.input.mouse_sensitivity");
+
+   MDFNMP_ApplyPeriodicCheats();
+
+
+   espec->MasterCycles = 0;
+   espec->SoundBufSize = 0;
+
+   FrontIO_UpdateInput();
+   GPU_StartFrame(espec);
+
+   Running = -1;
+   trace_start = MDFNTR_Begin();
+   PSX_PROF_ENTER(PSX_PROF_CPU);
+   timestamp = CPU->Run(timestamp, false);
+   PSX_PROF_LEAVE();
+   MDFNTR_End("CPU->Run", trace_start);
+
+   assert(timestamp);
+
+   trace_start = MDFNTR_Begin();
+   PSX_ForceEventUpdates(timestamp);
+   MDFNTR_End("PSX_ForceEventUpdates", trace_start);
+
+#if 0
+   if(GPU_GetScanlineNum() < 100)
+      PSX_DBG(PSX_DBG_ERROR, "[BUUUUUUUG] Frame timing end glitch; scanline=%u, st=%u\n", GPU_GetScanlineNum(), timestamp);
+#endif
+
+   //printf("scanline=%u, st=%u\n", GPU_GetScanlineNum(), timestamp);
+
+   espec->SoundBufSize = IntermediateBufferPos;
+   IntermediateBufferPos = 0;
+
+   CDC_ResetTS();
+   TIMER_ResetTS();
+   DMA_ResetTS();
+   GPU_ResetTS();
+   FrontIO_ResetTS();
+
+   PSX_RebaseTS(timestamp);
+
+   espec->MasterCycles = timestamp;
+}
+
+//
+// Run-ahead: after the real frame, fork the emulator state into memory, run
+// run_ahead_frames further frames on the same input and show the last of
+// them, then restore the fork.  The audio played is always the real frame's.
+// Only the last frame's picture is shown, so the real frame and the other
+// run-ahead frames run with espec->skip set.  The run-ahead frames don't show
+// up in PSX_Count, the PSX_PROF_* times(they're charged to the frontend) or
+// the trace.
+//
+// MainRAM, GPURAM and SPURAM stay out of the fork.  run_ahead_ram[] mirrors
+// them as of the last fork; forking copies in the pages written since the
+// last restore, and restoring copies back the pages the run-ahead frames
+// wrote, so a frame costs about what it dirtied rather than 3.5MiB each way.
+// Like the dirty tracking, this misses the frontend writing
+// RETRO_MEMORY_SYSTEM_RAM directly; such a write to a page the run-ahead
+// frames then touch is undone by the restore.
+//
+static int16_t run_ahead_audio[sizeof(IntermediateBuffer) / sizeof(IntermediateBuffer[0])][SOUND_CHANNELS];
+
+static void RunAhead_Region(StateTracked *tracked, unsigned region, uint8 *data, int load)
+{
+   const uint32 count = PSX_DirtyPageCount(region);
+   uint8 *copy        = run_ahead_ram[region];
+
+   for (uint32 page = 0; page < count; page++)
+   {
+      const uint32 offset = page << PSX_DIRTY_PAGE_SHIFT;
+
+      if (!PSX_DirtyTest(region, PSX_DIRTY_USER_RUN_AHEAD, page))
+         continue;
+
+      if (load)
+         memcpy(data + offset, copy + offset, PSX_DIRTY_PAGE_SIZE);
+      else
+         memcpy(copy + offset, data + offset, PSX_DIRTY_PAGE_SIZE);
+   }
+
+   PSX_DirtyReset(region, PSX_DIRTY_USER_RUN_AHEAD);
+}
+
+static StateTracked run_ahead_tracked = { RunAhead_Region };
+
+static void RunAhead(EmulateSpecStruct *espec)
+{
+   const int32 sound_size = espec->SoundBufSize;
+   const bool trace_active = MDFNTR_Active;
+   SPU_Stats discard;
+#ifdef PSX_PROFILE
+   PSX_ProfSnapshot prof;
+#endif
+
+   for (unsigned region = 0; region < PSX_DIRTY_REGION_COUNT; region++)
+   {
+      if (run_ahead_ram[region])
+         continue;
+
+      if (!(run_ahead_ram[region] = (uint8*)malloc(PSX_DirtyPageCount(region) << PSX_DIRTY_PAGE_SHIFT)))
+         goto fail;
+
+      // Enabling marks every page, so the first fork copies all of it.
+      PSX_DirtyEnable(region, PSX_DIRTY_USER_RUN_AHEAD, true);
+   }
+
+   run_ahead_state.loc     = 0;
+   run_ahead_state.len     = 0;
+   run_ahead_state.fast    = 1;
+   run_ahead_state.tracked = &run_ahead_tracked;
+
+   if (!MDFNGameInfo->StateAction(&run_ahead_state, 0, 0))
+      goto fail;
+
+   memcpy(run_ahead_audio, IntermediateBuffer, sound_size * sizeof(IntermediateBuffer[0]));
+
+   PSX_PROF_SAVE(&prof);
+   MDFNTR_Active = false;
+
+   for (unsigned i = 0; i < run_ahead_frames; i++)
+   {
+      espec->skip = (i + 1) < run_ahead_frames;
+      RunFrame(espec);
+   }
+
+   MDFNTR_Active = trace_active;
+   PSX_PROF_RESTORE(&prof);
+
+   SPU_GetStats(&discard);
+
+   run_ahead_state.loc = 0;
+   MDFNGameInfo->StateAction(&run_ahead_state, MEDNAFEN_VERSION_NUMERIC, 0);
+
+   memcpy(IntermediateBuffer, run_ahead_audio, sound_size * sizeof(IntermediateBuffer[0]));
+   espec->SoundBufSize = sound_size;
+   return;
+
+fail:
+   // The real frame's picture was skipped, so this frame shows the last one
+   // again; turn run-ahead off rather than do that every frame.
+   if (log_cb)
+      log_cb(RETRO_LOG_ERROR, "[%s]: Out of memory for run-ahead, disabling it.\n", MEDNAFEN_CORE_NAME);
+   run_ahead_frames = 0;
+   RunAhead_Kill();
+}
+
+//
+// Input movies(mednafen/movie.h).  A port's input is recorded as its button
+// word and eight analog axes, 16 bits each: everything FrontIO_UpdateInput()
+// reads from buf.  The rumble bytes are output only and aren't recorded.
+//
+#define MOVIE_PORT_SIZE (2 + 8 * 2)
+
+static void Movie_PackInput(uint8 *data)
+{
+   for (unsigned j = 0; j < players; j++, data += MOVIE_PORT_SIZE)
+   {
+      data[0] = buf.u8[j][0];
+      data[1] = buf.u8[j][1];
+
+      for (unsigned i = 0; i < 8; i++)
+         MDFN_en16lsb(data + 2 + i * 2, buf.u32[j][1 + i]);
+   }
+}
+
+static void Movie_UnpackInput(const uint8 *data)
+{
+   for (unsigned j = 0; j < players; j++, data += MOVIE_PORT_SIZE)
+   {
+      buf.u8[j][0] = data[0];
+      buf.u8[j][1] = data[1];
+
+      for (unsigned i = 0; i < 8; i++)
+         buf.u32[j][1 + i] = MDFN_de16lsb(data + 2 + i * 2);
+   }
+}
+
+static void Movie_Event(unsigned event, uint32 param)
+{
+   switch (event)
+   {
+      case MDFNMOV_EVENT_RESET:
+         retro_reset();
+         break;
+      case MDFNMOV_EVENT_EJECT:
+         disk_set_eject_state(param != 0);
+         break;
+      case MDFNMOV_EVENT_SELECT_DISC:
+         disk_set_image_index(param);
+         break;
+   }
+}
+
+// Records the input update_input() just read, or replaces it with the movie's.
+static void Movie_Frame(void)
+{
+   uint8 data[MAX_PLAYERS * MOVIE_PORT_SIZE];
+
+   if (rewind_active)
+   {
+      // The movie can't follow the emulator back in time.
+      if (log_cb)
+         log_cb(RETRO_LOG_WARN, "[%s]: Rewinding, movie stopped.\n", MEDNAFEN_CORE_NAME);
+      MDFNMOV_Stop();
+      return;
+   }
+
+   if (MDFNMOV_GetMode() == MDFNMOV_RECORDING)
+   {
+      Movie_PackInput(data);
+      MDFNMOV_RecordFrame(data);
+   }
+   else if (MDFNMOV_PlayFrame(data, Movie_Event))
+      Movie_UnpackInput(data);
+}
+
 void retro_run(void)
 {
    bool updated = false;
+   const retro_perf_tick_t start_ticks = audio_stats_timing && perf_cb.get_perf_counter ? perf_cb.get_perf_counter() : 0;
+   const retro_time_t start_usec = audio_stats_timing && perf_cb.get_time_usec ? perf_cb.get_time_usec() : 0;
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE, &updated) && updated)
       check_variables();
 
+   if (trace_option_changed)
+   {
+      if (trace_option)
+         retro_psx_trace_start(MDFN_MakeFName(MDFNMKF_SAV, 0, "trace.json").c_str(), trace_option == 2);
+      else
+         retro_psx_trace_stop();
+      trace_option_changed = false;
+   }
+
+   const uint64 trace_frame = MDFNTR_Begin();
+   uint64 trace_start;
+
    if(pending_messages)
    {
       if(video_frames%120 == 0 && video_frames > 0)
@@ -2874,12 +3660,21 @@ void retro_run(void)
       setting_apply_analog_toggle = false;
    }
 
+   trace_start = MDFNTR_Begin();
+
    input_poll_cb();
 
    update_input();
 
+   if (MDFNMOV_GetMode() != MDFNMOV_IDLE)
+      Movie_Frame();
+
+   MDFNTR_End("input_poll", trace_start);
+
+   if (rewind_active)
+      MDFNSRW_Rewind();
+
    static int32 rects[MEDNAFEN_CORE_GEOMETRY_MAX_H];
-   rects[0] = ~0;
 
    EmulateSpecStruct spec = {0};
    spec.surface = surf;
@@ -2888,49 +3683,14 @@ void retro_run(void)
    spec.LineWidths = rects;
    spec.SoundBufSize = 0;
    spec.VideoFormatChanged = false;
+   spec.skip = run_ahead_frames && !rewind_active;
 
-   EmulateSpecStruct *espec = (EmulateSpecStruct*)&spec;
-   /* start of Emulate */
-   int32_t timestamp = 0;
-
-   espec->skip = false;	
-   MDFNGameInfo->mouse_sensitivity = MDFN_GetSettingF("psx.input.mouse_sensitivity");
-
-   MDFNMP_ApplyPeriodicCheats();
-
-
-   espec->MasterCycles = 0;
-   espec->SoundBufSize = 0;
+   RunFrame(&spec);
 
-   FrontIO_UpdateInput();
-   GPU_StartFrame(espec);
+   const int32_t timestamp = spec.MasterCycles;
+   SPU_Stats spu_stats;
 
-   Running = -1;
-   timestamp = CPU->Run(timestamp, false);
-
-   assert(timestamp);
-
-   PSX_ForceEventUpdates(timestamp);
-
-#if 0
-   if(GPU_GetScanlineNum() < 100)
-      PSX_DBG(PSX_DBG_ERROR, "[BUUUUUUUG] Frame timing end glitch; scanline=%u, st=%u\n", GPU_GetScanlineNum(), timestamp);
-#endif
-
-   //printf("scanline=%u, st=%u\n", GPU_GetScanlineNum(), timestamp);
-
-   espec->SoundBufSize = IntermediateBufferPos;
-   IntermediateBufferPos = 0;
-
-   CDC_ResetTS();
-   TIMER_ResetTS();
-   DMA_ResetTS();
-   GPU_ResetTS();
-   FrontIO_ResetTS();
-
-   PSX_RebaseTS(timestamp);
-
-   espec->MasterCycles = timestamp;
+   SPU_GetStats(&spu_stats);
 
    // Save memcards if dirty.
    for(int i = 0; i < players; i++)
@@ -2959,15 +3719,29 @@ void retro_run(void)
                continue;
             }
 
-            char ext[64];
-            snprintf(ext, sizeof(ext), "%d.mcr", i);
-            FrontIO_SaveMemcard(i, MDFN_MakeFName(MDFNMKF_SAV, 0, ext).c_str());
+            trace_start = MDFNTR_Begin();
+            Memcard_Flush(i);
+            MDFNTR_End("Memcard_Flush", trace_start);
             Memcard_SaveDelay[i] = -1;
             Memcard_PrevDC[i] = 0;
          }
       }
    }
 
+   if (!rewind_active)
+   {
+      trace_start = MDFNTR_Begin();
+      MDFNSRW_Frame();
+      MDFNTR_End("MDFNSRW_Frame", trace_start);
+   }
+
+   if (run_ahead_frames && !rewind_active)
+   {
+      trace_start = MDFNTR_Begin();
+      RunAhead(&spec);
+      MDFNTR_End("RunAhead", trace_start);
+   }
+
    /* end of Emulate */
 
 #ifdef NEED_DEINTERLACER
@@ -2976,7 +3750,9 @@ void retro_run(void)
       if (!PrevInterlaced)
          Deinterlacer_ClearState();
 
+      trace_start = MDFNTR_Begin();
       Deinterlacer_Process(spec.surface, &spec.DisplayRect, spec.LineWidths, spec.InterlaceField);
+      MDFNTR_End("Deinterlacer_Process", trace_start);
 
       PrevInterlaced = true;
 
@@ -2989,6 +3765,8 @@ void retro_run(void)
 
    int16_t *interbuf = (int16_t*)&IntermediateBuffer;
 
+   trace_start = MDFNTR_Begin();
+
    // PSX is rather special, and needs specific handling ...
    
    unsigned width = rects[0]; // spec.DisplayRect.w is 0. Only rects[0].w seems to return something sane.
@@ -3039,7 +3817,7 @@ void retro_run(void)
             break;
       }
       
-      if ((PSX_CalcDiscSCEx() == REGION_EU))
+      if (cdifs_region == REGION_EU)
       {
          // Attempt to remove black bars.
          // These numbers are arbitrary since the bars differ some by game.
@@ -3049,11 +3827,27 @@ void retro_run(void)
       }
    }
    video_cb(pix, width, height, MEDNAFEN_CORE_GEOMETRY_MAX_W << 2);
+   MDFNTR_End("video_cb", trace_start);
 
    video_frames++;
    audio_frames += spec.SoundBufSize;
 
+   trace_start = MDFNTR_Begin();
    audio_batch_cb(interbuf, spec.SoundBufSize);
+   MDFNTR_End("audio_batch_cb", trace_start);
+
+   if (audio_stats_timing && perf_cb.get_perf_counter && perf_cb.get_time_usec)
+      update_audio_stats(&spu_stats, perf_cb.get_perf_counter() - start_ticks, perf_cb.get_time_usec() - start_usec);
+   else
+      update_audio_stats(&spu_stats, 0, 0);
+
+#ifdef PSX_PROFILE
+   counters_frame = PSX_Count;
+   memset(&PSX_Count, 0, sizeof(PSX_Count));
+#endif
+
+   if (MDFNTR_Active && trace_frame)
+      MDFNTR_Add("retro_run", trace_frame, MDFNTR_Now(), video_frames);
 }
 
 void retro_get_system_info(struct retro_system_info *info)
@@ -3109,6 +3903,9 @@ unsigned retro_api_version(void)
 
 void retro_set_controller_port_device(unsigned in_port, unsigned device)
 {
+   if (in_port < MAX_PLAYERS)
+      input_device[in_port] = device;
+
    switch (device)
    {
       case RETRO_DEVICE_JOYPAD:
@@ -3155,6 +3952,12 @@ void retro_set_environment(retro_environment_t cb)
       { "beetle_psx_use_mednafen_memcard0_method", "Memcard 0 method; libretro|mednafen" },
       { "beetle_psx_shared_memory_cards", "Shared memcards (restart); disabled|enabled" },
       { "beetle_psx_experimental_save_states", "Savestates (restart); disabled|enabled" },
+      { "beetle_psx_savestate_format", "Savestate format (fast is for run-ahead/rewind, this build only); portable|fast" },
+      { "beetle_psx_rewind", "Built-in rewind; disabled|enabled" },
+      { "beetle_psx_rewind_granularity", "Rewind granularity (frames); 2|1|3|4|5|6|10|15|20|30|60" },
+      { "beetle_psx_rewind_buffer_size", "Rewind buffer size (MB); 256|64|128|512|1024|2048" },
+      { "beetle_psx_run_ahead", "Run-ahead (frames); 0|1|2|3|4" },
+      { "beetle_psx_trace", "Timeline trace (Chrome trace JSON in the save directory); disabled|frame phases|frame phases and events" },
       { "beetle_psx_initial_scanline", "Initial scanline; 0|1|2|3|4|5|6|7|8|9|10|10|11|12|13|14|15|16|17|18|19|20|21|22|23|24|25|26|27|28|29|30|31|32|33|34|35|36|37|38|39|40" },
       { "beetle_psx_initial_scanline_pal", "Initial scanline PAL; 0|1|2|3|4|5|6|7|8|9|10|10|11|12|13|14|15|16|17|18|19|20|21|22|23|24|25|26|27|28|29|30|31|32|33|34|35|36|37|38|39|40" },
       { "beetle_psx_last_scanline", "Last scanline; 239|238|237|236|235|234|232|231|230|229|228|227|226|225|224|223|222|221|220|219|218|217|216|215|214|213|212|211|210" },
@@ -3162,6 +3965,11 @@ void retro_set_environment(retro_environment_t cb)
       { "beetle_psx_analog_toggle", "Dualshock analog toggle; disabled|enabled" },
       { "beetle_psx_enable_multitap_port1", "Port 1: Multitap enable; disabled|enabled" },
       { "beetle_psx_enable_multitap_port2", "Port 2: Multitap enable; disabled|enabled" },
+      { "beetle_psx_audio_stats", "Audio stats (SPU timing); disabled|enabled|log" },
+      { "beetle_psx_cd_load_into_ram", "Load disc into RAM (restart); disabled|enabled" },
+#ifdef HAVE_CHD
+      { "beetle_psx_chd_hunk_cache", "CHD hunk cache size (restart); 64|16|32|128|256|512" },
+#endif
       { NULL, NULL },
    };
    static const struct retro_controller_description pads[] = {
@@ -3237,13 +4045,68 @@ static int MDFNSS_SaveSM(void* st_p, int a, int b, const void *c, const void *d,
    return (1);
 }
 
+//
+// Fixed-layout states: the same StateAction() walk, but every section is
+// stored as the raw in-memory bytes of its SFORMAT entries(see
+// MDFNSS_StateAction()).  Much cheaper to produce and restore than the
+// portable format, which stays the right choice for anything kept on disk.
+//
+#define FAST_STATE_VERSION 1
+
+static uint32 FastStateHostTag(void)
+{
+#ifdef MSB_FIRST
+   return (1U << 16) | (uint32)sizeof(bool);
+#else
+   return (uint32)sizeof(bool);
+#endif
+}
+
+static int MDFNSS_SaveSMFast(StateMem* st)
+{
+   uint8 header[32];
+   int ret;
+
+   memset(header, 0, sizeof(header));
+   memcpy(header, "MDFNFAST", 8);
+
+   MDFN_en32lsb(header + 16, MEDNAFEN_VERSION_NUMERIC);
+   MDFN_en32lsb(header + 20, FAST_STATE_VERSION);
+   MDFN_en32lsb(header + 24, FastStateHostTag());
+   smem_write(st, header, 32);
+
+   st->fast = 1;
+   ret = MDFNGameInfo->StateAction(st, 0, 0);
+   st->fast = 0;
+
+   return ret;
+}
+
 static int MDFNSS_LoadSM(void* st_p, int unused, int unused2)
 {
    StateMem* st = (StateMem*)st_p;
    uint8 header[32];
    uint32 stateversion;
+   int ret;
+
+   if (smem_read(st, header, 32) != 32)
+      return (0);
+
+   if (!memcmp(header, "MDFNFAST", 8))
+   {
+      if (MDFN_de32lsb(header + 20) != FAST_STATE_VERSION || MDFN_de32lsb(header + 24) != FastStateHostTag())
+      {
+         if (log_cb)
+            log_cb(RETRO_LOG_ERROR, "[mednafen]: Fast savestate was made by an incompatible build.\n");
+         return (0);
+      }
 
-   smem_read(st, header, 32);
+      st->fast = 1;
+      ret = MDFNGameInfo->StateAction(st, MDFN_de32lsb(header + 16), 0);
+      st->fast = 0;
+
+      return ret;
+   }
 
    if (memcmp(header, "MEDNAFENSVESTATE", 16) && memcmp(header, "MDFNSVST", 8))
       return (0);
@@ -3253,21 +4116,29 @@ static int MDFNSS_LoadSM(void* st_p, int unused, int unused2)
    return (MDFNGameInfo->StateAction(st, stateversion, 0));
 }
 
+static int SaveStateSM(StateMem* st)
+{
+   if (fast_savestates)
+      return MDFNSS_SaveSMFast(st);
+
+   return MDFNSS_SaveSM(st, 0, 0, NULL, NULL, NULL);
+}
+
 static size_t serialize_size;
 
 size_t retro_serialize_size(void)
 {
    StateMem st;
    memset(&st, 0, sizeof(st));
+   st.size_only = 1;
 
-   if (!MDFNSS_SaveSM(&st, 0, 0, NULL, NULL, NULL) || !experimental_savestates)
+   if (!SaveStateSM(&st) || !experimental_savestates)
    {
       if (log_cb)
          log_cb(RETRO_LOG_WARN, "[mednafen]: Save states might destroy your memory card data\n");
       return 0;
    }
 
-   free(st.data);
    return serialize_size = st.len;
 }
 
@@ -3278,7 +4149,19 @@ bool retro_serialize(void *data, size_t size)
    st.data     = (uint8_t*)data;
    st.malloced = size;
 
-   return MDFNSS_SaveSM(&st, 0, 0, NULL, NULL, NULL);
+   return SaveStateSM(&st);
+}
+
+// Whether the frontend is saving and loading states for its own run-ahead
+// or netplay rollback rather than for the user.
+static bool frontend_replaying(void)
+{
+   int flags = 0;
+
+   if (!environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &flags))
+      return false;
+
+   return (flags & 4) != 0;
 }
 
 bool retro_unserialize(const void *data, size_t size)
@@ -3287,8 +4170,124 @@ bool retro_unserialize(const void *data, size_t size)
    memset(&st, 0, sizeof(st));
    st.data = (uint8_t*)data;
    st.len  = size;
-   
-   return MDFNSS_LoadSM(&st, 0, 0);
+
+   if (!MDFNSS_LoadSM(&st, 0, 0))
+      return false;
+
+   // Like rewinding, a state load takes the emulator somewhere the movie
+   // didn't go.
+   if (MDFNMOV_GetMode() != MDFNMOV_IDLE)
+   {
+      if (log_cb)
+         log_cb(RETRO_LOG_WARN, "[%s]: State loaded, movie stopped.\n", MEDNAFEN_CORE_NAME);
+      MDFNMOV_Stop();
+   }
+
+   // Rewind history recorded past this point no longer applies, but only
+   // for loads the user asked for.  The frontend's run-ahead and netplay
+   // load a state every frame just to replay frames on the same timeline;
+   // clearing then would leave rewind with nothing, ever.  The history
+   // does keep snapshots taken during the frames they later throw away.
+   if (!frontend_replaying())
+      MDFNSRW_Clear();
+   return true;
+}
+
+bool retro_psx_movie_record(const char *path, bool from_state)
+{
+   MDFNMOV_Info info;
+   StateMem st;
+   bool ret;
+
+   if (!MDFNGameInfo)
+      return false;
+
+   memset(&info, 0, sizeof(info));
+   info.ports     = players;
+   info.port_size = MOVIE_PORT_SIZE;
+   memcpy(info.port_device, input_device, sizeof(input_device));
+   memcpy(info.md5, MDFNGameInfo->MD5, 16);
+
+   memset(&st, 0, sizeof(st));
+
+   if (from_state && !MDFNSS_SaveSM(&st, 0, 0, NULL, NULL, NULL))
+   {
+      free(st.data);
+      return false;
+   }
+
+   ret = MDFNMOV_StartRecord(path, &info, st.data, st.len);
+   free(st.data);
+
+   if (ret && !from_state)
+   {
+      PSX_Power();
+      MDFNSRW_Clear();
+   }
+
+   return ret;
+}
+
+bool retro_psx_movie_play(const char *path)
+{
+   MDFNMOV_Info info;
+   const uint8 *state;
+   uint32 state_size;
+
+   if (!MDFNGameInfo || !MDFNMOV_StartPlay(path, &info, &state, &state_size))
+      return false;
+
+   if (info.ports != players || info.port_size != MOVIE_PORT_SIZE)
+   {
+      if (log_cb)
+         log_cb(RETRO_LOG_ERROR, "[%s]: Movie was recorded with %u ports, %u are connected; check the multitap settings.\n",
+               MEDNAFEN_CORE_NAME, info.ports, players);
+      MDFNMOV_Stop();
+      return false;
+   }
+
+   if (memcmp(info.md5, MDFNGameInfo->MD5, 16) && log_cb)
+      log_cb(RETRO_LOG_WARN, "[%s]: Movie was recorded on a different game, it will likely desync.\n", MEDNAFEN_CORE_NAME);
+
+   for (unsigned i = 0; i < info.ports; i++)
+   {
+      if (info.port_device[i] != input_device[i])
+         retro_set_controller_port_device(i, info.port_device[i]);
+   }
+
+   if (state)
+   {
+      StateMem st;
+      memset(&st, 0, sizeof(st));
+      st.data = (uint8_t*)state;
+      st.len  = state_size;
+
+      if (!MDFNSS_LoadSM(&st, 0, 0))
+      {
+         if (log_cb)
+            log_cb(RETRO_LOG_ERROR, "[%s]: Couldn't load the movie's savestate.\n", MEDNAFEN_CORE_NAME);
+         MDFNMOV_Stop();
+         return false;
+      }
+   }
+   else
+      PSX_Power();
+
+   MDFNSRW_Clear();
+
+   return true;
+}
+
+void retro_psx_movie_stop(void)
+{
+   MDFNMOV_Stop();
+}
+
+void retro_psx_movie_get_status(struct retro_psx_movie_status *status)
+{
+   status->mode   = (enum retro_psx_movie_mode)MDFNMOV_GetMode();
+   status->frame  = MDFNMOV_GetFrame();
+   status->length = MDFNMOV_GetLength();
 }
 
 void *retro_get_memory_data(unsigned type)
@@ -0,0 +1,179 @@
+#ifndef LIBRETRO_PSX_EXT_H__
+#define LIBRETRO_PSX_EXT_H__
+
+/* Beetle PSX specific extensions to the libretro API.
+ *
+ * These are plain exported functions (they match the retro_* export
+ * pattern in link.T), so a host that dlopen()s the core can look them
+ * up with dlsym() and fall back gracefully when they are missing.
+ */
+
+#include "libretro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Audio output health, updated at the end of every retro_run(). */
+struct retro_psx_audio_stats
+{
+   uint64_t frames;              /* retro_run() calls since load/reset of the stats. */
+
+   uint32_t samples;             /* Stereo samples produced by the last retro_run(). */
+   uint32_t samples_min;         /* Fewest/most samples produced by any one retro_run(). */
+   uint32_t samples_max;
+
+   uint64_t overflow_frames;     /* Frames where the 4096-sample intermediate buffer filled up... */
+   uint64_t samples_dropped;     /* ...and the total samples thrown away because of it. */
+
+   uint32_t active_voices;       /* Most SPU voices with a non-zero envelope during the last frame. */
+
+   uint64_t spu_time_usec;       /* Host time spent in the SPU during the last frame, and in total.  Only */
+   uint64_t spu_time_usec_total; /* available when the frontend provides a perf interface; 0 otherwise. */
+};
+
+/* Copies the current counters to *stats.  If reset is true, the
+ * accumulated (min/max/total) counters are cleared afterwards. */
+void retro_psx_get_audio_stats(struct retro_psx_audio_stats *stats, bool reset);
+
+/* Built-in rewind; history is only recorded while the beetle_psx_rewind
+ * core option is enabled. */
+struct retro_psx_rewind_stats
+{
+   uint32_t snapshots;           /* Snapshots that can still be rewound to. */
+   uint32_t frames_per_snapshot; /* The beetle_psx_rewind_granularity setting. */
+   uint64_t bytes_used;          /* Memory held for the history, including the working snapshots. */
+   uint64_t bytes_budget;        /* The beetle_psx_rewind_buffer_size setting, in bytes. */
+};
+
+/* While active is true, every retro_run() first steps back to the previous
+ * snapshot(repeating the oldest one once the history runs out) and then
+ * emulates a frame from there to produce video.  No history is recorded
+ * while rewinding. */
+void retro_psx_set_rewind(bool active);
+
+void retro_psx_get_rewind_stats(struct retro_psx_rewind_stats *stats);
+
+/* Dirty page tracking: which 4KiB pages of a memory region may have
+ * changed since the last reset.  Tracking is off until enabled, and a
+ * region that isn't tracked reports every page as dirty. */
+enum retro_psx_memory_region
+{
+   RETRO_PSX_MEMORY_MAIN_RAM = 0, /* 2MiB, as RETRO_MEMORY_SYSTEM_RAM. */
+   RETRO_PSX_MEMORY_VRAM,         /* 1MiB, 1024x512 16-bit pixels, row-major. */
+   RETRO_PSX_MEMORY_SPU_RAM       /* 512KiB. */
+};
+
+void retro_psx_dirty_enable(enum retro_psx_memory_region region, bool enable);
+
+/* Number of pages in region; bitmaps passed to retro_psx_dirty_get()
+ * need (count + 7) / 8 bytes. */
+unsigned retro_psx_dirty_page_count(enum retro_psx_memory_region region);
+
+/* Fills bitmap with one bit per page(LSB first), clears the tracked
+ * state afterwards if reset is true, and returns the dirty page count. */
+unsigned retro_psx_dirty_get(enum retro_psx_memory_region region, uint8_t *bitmap, bool reset);
+
+/* State fingerprints for replay/lockstep desync detection.  Each savestate
+ * section (CPU, GTE, GPU, SPU, CDC, DMA, TIMER, FIO, ...) is hashed on its
+ * own and the section hashes are combined into one value.  Hashes only
+ * compare between identical builds on hosts of the same endianness. */
+struct retro_psx_state_hash_section
+{
+   char name[32];
+   uint64_t hash;
+};
+
+/* Hashes the current state; call between retro_run()s.  Memory pages
+ * that weren't written since the last call reuse their cached hashes
+ * unless full is true.  Returns 0 on failure. */
+uint64_t retro_psx_state_hash(bool full);
+
+/* Copies up to max sections of the last retro_psx_state_hash() and
+ * returns how many there are. */
+unsigned retro_psx_state_hash_sections(struct retro_psx_state_hash_section *sections, unsigned max);
+
+/* Compares the last retro_psx_state_hash() with sections from another
+ * run(e.g. the peer's, or a replay's recorded ones), logs every section
+ * that differs or is missing, and returns how many do. */
+unsigned retro_psx_state_hash_compare(const struct retro_psx_state_hash_section *sections, unsigned count);
+
+/* Counts of the work done on the emulator's hot paths during the last
+ * retro_run().  Only builds with PSX_PROFILE defined(tools/psxbench)
+ * count; elsewhere retro_psx_get_counters() zeroes *counters and
+ * returns false. */
+struct retro_psx_counters
+{
+   uint64_t cpu_instructions;
+   uint64_t cpu_icache_misses;   /* I-cache line fills. */
+
+   uint64_t gpu_commands[256];   /* GP0 commands executed, by opcode. */
+   uint64_t gpu_pixels;          /* Pixels written by drawing, fills, copies and uploads. */
+
+   uint64_t dma_words[7];        /* By channel: MDEC in, MDEC out, GPU, CD, SPU, PIO, OTC. */
+
+   uint64_t spu_samples;
+   uint64_t spu_voice_samples;   /* Voices with a non-zero envelope, summed over the samples. */
+
+   uint64_t cd_sectors;          /* Sectors read from the disc image... */
+   uint64_t cd_xa_sectors;       /* ...and XA ADPCM sectors decoded. */
+
+   uint64_t events_gpu;          /* Event dispatches, by type. */
+   uint64_t events_cdc;
+   uint64_t events_timer;
+   uint64_t events_dma;
+   uint64_t events_fio;
+};
+
+bool retro_psx_get_counters(struct retro_psx_counters *counters);
+
+/* Timeline tracing: host time spans for the phases of every retro_run()
+ * (input_poll, CPU->Run, PSX_ForceEventUpdates, Deinterlacer_Process,
+ * video_cb, audio_batch_cb, memcard flushes, rewind capture, run-ahead)
+ * and, if events is true, for every emulated event dispatch(GPU, CDC,
+ * timer, DMA, pad/memcard), written to path as Chrome trace JSON by a
+ * background thread.  Open it in chrome://tracing or ui.perfetto.dev.
+ * Event spans are numerous(thousands per frame, tens of MB per emulated
+ * second), so keep such traces short.  The
+ * beetle_psx_trace core option does the same, tracing to a .trace.json
+ * file named like the game's memory cards, in the save directory. */
+bool retro_psx_trace_start(const char *path, bool events);
+void retro_psx_trace_stop(void);
+
+/* Input movies: every frame's controller input plus reset and disc
+ * eject/swap events, for deterministic replay of a session.  The core's
+ * rewind ends a movie; frontend run-ahead or savestate loading while one
+ * is active makes it desync. */
+enum retro_psx_movie_mode
+{
+   RETRO_PSX_MOVIE_IDLE = 0,
+   RETRO_PSX_MOVIE_RECORDING,
+   RETRO_PSX_MOVIE_PLAYING
+};
+
+struct retro_psx_movie_status
+{
+   enum retro_psx_movie_mode mode;
+   uint64_t frame;               /* Frames recorded/played so far. */
+   uint64_t length;              /* Length of the movie being played, 0 if unknown. */
+};
+
+/* Starts recording to path, from a savestate of the current state
+ * embedded in the movie if from_state is true, else from power-on(the
+ * console is power cycled). */
+bool retro_psx_movie_record(const char *path, bool from_state);
+
+/* Restores the movie's starting point and replays it; live input is
+ * ignored until it ends. */
+bool retro_psx_movie_play(const char *path);
+
+/* Finishes a recording or ends playback. */
+void retro_psx_movie_stop(void);
+
+void retro_psx_movie_get_status(struct retro_psx_movie_status *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
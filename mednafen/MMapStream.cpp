@@ -0,0 +1,294 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "mednafen.h"
+#include "error.h"
+#include "MMapStream.h"
+#include "FileStream.h"
+
+#if defined(_WIN32) && !defined(_XBOX)
+#include <windows.h>
+#define MMAPSTREAM_SUPPORTED
+#elif defined(__unix__) || defined(__APPLE__) || defined(__HAIKU__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/vfs.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#include <sys/param.h>
+#include <sys/mount.h>
+#define MMAPSTREAM_MNT_LOCAL
+#endif
+#define MMAPSTREAM_SUPPORTED
+#endif
+
+//
+// A mapped page that can't be read(a network share dropping out, a card or disc pulled, the
+// file truncated underneath us) raises SIGBUS or an in-page exception rather than a read
+// error, so only regular files on local, fixed storage are mapped; anything else goes
+// through FileStream.  Nothing stops another program truncating a mapped file on a local
+// disk(Windows refuses to), so don't do that while the game is running.
+//
+#if defined(_WIN32) && !defined(_XBOX)
+static bool MapSafe(HANDLE fh, const char *path)
+{
+   char volume[MAX_PATH];
+
+   if(GetFileType(fh) != FILE_TYPE_DISK)
+      return(false);
+
+   if(!GetVolumePathNameA(path, volume, sizeof(volume)))
+      return(false);
+
+   return(GetDriveTypeA(volume) == DRIVE_FIXED);
+}
+#elif defined(MMAPSTREAM_SUPPORTED)
+static bool MapSafe(int fd, const struct stat *buf)
+{
+   if(!S_ISREG(buf->st_mode))
+      return(false);
+
+#if defined(__linux__)
+   struct statfs fs;
+
+   if(fstatfs(fd, &fs) == -1)
+      return(false);
+
+   switch((uint32)fs.f_type)
+   {
+      case 0x00006969:	// NFS
+      case 0x0000517B:	// SMB
+      case 0xFE534D42:	// SMB2
+      case 0xFF534D42:	// CIFS
+      case 0x01021997:	// 9P
+      case 0x00C36400:	// Ceph
+      case 0x73757245:	// Coda
+      case 0x5346414F:	// AFS
+      case 0x65735546:	// FUSE(sshfs and friends, and NTFS/exFAT on USB drives)
+      case 0x00004D44:	// FAT
+      case 0x2011BAB0:	// exFAT
+      case 0x00009660:	// ISO 9660
+      case 0x15013346:	// UDF
+         return(false);
+   }
+#elif defined(MMAPSTREAM_MNT_LOCAL)
+   struct statfs fs;
+
+   if(fstatfs(fd, &fs) == -1 || !(fs.f_flags & MNT_LOCAL))
+      return(false);
+#ifdef MNT_REMOVABLE
+   if(fs.f_flags & MNT_REMOVABLE)
+      return(false);
+#endif
+#endif
+
+   return(true);
+}
+#endif
+
+MMapStream::MMapStream(const char *path) : data_buffer(NULL), data_buffer_size(0), position(0)
+{
+#if defined(_WIN32) && !defined(_XBOX)
+   LARGE_INTEGER fsize;
+
+   file_handle = NULL;
+   map_handle = NULL;
+
+   HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+
+   if(fh == INVALID_HANDLE_VALUE)
+      throw(MDFN_Error(0, "Error opening file \"%s\"", path));
+
+   if(!GetFileSizeEx(fh, &fsize) || (uint64)fsize.QuadPart > SIZE_MAX || !MapSafe(fh, path))
+   {
+      CloseHandle(fh);
+      throw(MDFN_Error(0, "Error mapping file \"%s\"", path));
+   }
+
+   file_handle = fh;
+   data_buffer_size = fsize.QuadPart;
+
+   if(data_buffer_size)	// Zero-length files can't be mapped; leave data_buffer NULL.
+   {
+      if(!(map_handle = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL)) ||
+         !(data_buffer = (uint8 *)MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0)))
+      {
+         close();
+         throw(MDFN_Error(0, "Error mapping file \"%s\"", path));
+      }
+   }
+#elif defined(MMAPSTREAM_SUPPORTED)
+   struct stat buf;
+   int fd;
+
+   if((fd = open(path, O_RDONLY)) == -1)
+   {
+      ErrnoHolder ene(errno);
+      throw(MDFN_Error(ene.Errno(), "Error opening file %s", ene.StrError()));
+   }
+
+   if(fstat(fd, &buf) == -1 || (uint64)buf.st_size > SIZE_MAX || !MapSafe(fd, &buf))
+   {
+      ::close(fd);
+      throw(MDFN_Error(0, "Error mapping file \"%s\"", path));
+   }
+
+   data_buffer_size = buf.st_size;
+
+   if(data_buffer_size)
+   {
+      void *p = mmap(NULL, data_buffer_size, PROT_READ, MAP_SHARED, fd, 0);
+
+      if(p == MAP_FAILED)
+      {
+         ErrnoHolder ene(errno);
+         ::close(fd);
+         throw(MDFN_Error(ene.Errno(), "Error mapping file %s", ene.StrError()));
+      }
+
+      data_buffer = (uint8 *)p;
+   }
+
+   // The mapping holds its own reference to the file.
+   ::close(fd);
+#else
+   throw(MDFN_Error(0, "Memory-mapped files aren't supported on this platform."));
+#endif
+}
+
+MMapStream::~MMapStream()
+{
+   close();
+}
+
+uint64 MMapStream::read(void *data, uint64 count, bool error_on_eos)
+{
+   if((uint64)position >= data_buffer_size)
+      return 0;
+
+   if(count > (data_buffer_size - position))
+      count = data_buffer_size - position;
+
+   memcpy(data, &data_buffer[position], count);
+   position += count;
+
+   return count;
+}
+
+void MMapStream::write(const void *data, uint64 count)
+{
+   throw(MDFN_Error(0, "Attempt to write to a read-only stream."));
+}
+
+void MMapStream::seek(int64 offset, int whence)
+{
+   int64 new_position;
+
+   switch(whence)
+   {
+      default:
+         assert(false);
+         break;
+
+      case SEEK_SET:
+         new_position = offset;
+         break;
+
+      case SEEK_CUR:
+         new_position = position + offset;
+         break;
+
+      case SEEK_END:
+         new_position = data_buffer_size + offset;
+         break;
+   }
+
+   // Seeking past the end is allowed, like with FileStream; reads there just return 0.
+   assert(new_position >= 0);
+
+   position = new_position;
+}
+
+int64 MMapStream::tell(void)
+{
+   return position;
+}
+
+int64 MMapStream::size(void)
+{
+   return data_buffer_size;
+}
+
+void MMapStream::close(void)
+{
+#if defined(_WIN32) && !defined(_XBOX)
+   if(data_buffer)
+      UnmapViewOfFile(data_buffer);
+   if(map_handle)
+      CloseHandle((HANDLE)map_handle);
+   if(file_handle)
+      CloseHandle((HANDLE)file_handle);
+
+   map_handle = NULL;
+   file_handle = NULL;
+#elif defined(MMAPSTREAM_SUPPORTED)
+   if(data_buffer)
+      munmap(data_buffer, data_buffer_size);
+#endif
+
+   data_buffer = NULL;
+   data_buffer_size = 0;
+   position = 0;
+}
+
+int MMapStream::get_line(std::string &str)
+{
+   str.clear();
+
+   while((uint64)position < data_buffer_size)
+   {
+      uint8 c = data_buffer[position++];
+
+      if(c == '\r' || c == '\n' || c == 0)
+         return(c);
+
+      str.push_back(c);
+   }
+
+   return(-1);
+}
+
+Stream *MDFN_OpenReadStream(const char *path)
+{
+#ifdef MMAPSTREAM_SUPPORTED
+   try
+   {
+      return new MMapStream(path);
+   }
+   catch(std::exception &e)
+   {
+      // Fall through; FileStream will report the error if the file really can't be opened.
+   }
+#endif
+
+   return new FileStream(path, FileStream::MODE_READ);
+}
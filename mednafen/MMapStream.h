@@ -0,0 +1,60 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __MDFN_MMAPSTREAM_H
+#define __MDFN_MMAPSTREAM_H
+
+#include "Stream.h"
+
+// Read-only stream over a memory-mapped file.  Reads are a memcpy() out of the mapping, and the pages
+// are shared(through the OS page cache) with anything else mapping or reading the same file.
+//
+// The constructor throws MDFN_Error if the file can't be mapped(including on platforms without
+// mmap support) or shouldn't be(anything but a regular file on a local, fixed disk), so callers
+// should be prepared to fall back to FileStream.
+class MMapStream : public Stream
+{
+ public:
+
+ MMapStream(const char *path);
+ virtual ~MMapStream();
+
+ virtual uint64 read(void *data, uint64 count, bool error_on_eos = true);
+ virtual void write(const void *data, uint64 count);
+ virtual void seek(int64 offset, int whence);
+ virtual int64 tell(void);
+ virtual int64 size(void);
+ virtual void close(void);
+
+ virtual int get_line(std::string &str);
+
+ private:
+ uint8 *data_buffer;
+ uint64 data_buffer_size;
+
+ int64 position;
+
+#ifdef _WIN32
+ void *file_handle;
+ void *map_handle;
+#endif
+};
+
+// Opens "path" for reading as an MMapStream if possible, otherwise as a FileStream.
+Stream *MDFN_OpenReadStream(const char *path);
+
+#endif
@@ -0,0 +1,229 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mednafen.h"
+#include "async_writer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_XBOX)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__) || defined(__HAIKU__)
+#include <unistd.h>
+#define HAVE_FSYNC
+#endif
+
+#include "../libretro.h"
+
+extern retro_log_printf_t log_cb;
+
+static bool Writer_RenameOver(const char *tmp_path, const char *path)
+{
+#if defined(_WIN32) && !defined(_XBOX)
+ return MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+ return rename(tmp_path, path) == 0;
+#endif
+}
+
+static void Writer_SaveFile(const std::string &path, const std::vector<uint8> &data)
+{
+ const std::string tmp_path = path + ".tmp";
+ FILE *fp = fopen(tmp_path.c_str(), "wb");
+ bool ok;
+
+ if(!fp)
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_ERROR, "Error opening \"%s\" for writing.\n", tmp_path.c_str());
+  return;
+ }
+
+ ok = fwrite(&data[0], 1, data.size(), fp) == data.size();
+ ok &= fflush(fp) == 0;
+#ifdef HAVE_FSYNC
+ ok &= fsync(fileno(fp)) == 0;
+#endif
+ ok &= fclose(fp) == 0;
+
+ if(!ok || !Writer_RenameOver(tmp_path.c_str(), path.c_str()))
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_ERROR, "Error writing \"%s\".\n", path.c_str());
+  remove(tmp_path.c_str());
+ }
+}
+
+#ifdef WANT_THREADING
+struct Writer_Job
+{
+ std::string path;
+ std::vector<uint8> data;
+};
+
+static std::deque<Writer_Job> Writer_Queue;
+static bool Writer_Busy = false;
+static bool Writer_Quit = false;
+
+static MDFN_Thread *Writer_Thread = NULL;
+static MDFN_Mutex *Writer_Mutex = NULL;
+static MDFN_Cond *Writer_WorkCond = NULL;	// Writer waits for jobs.
+static MDFN_Cond *Writer_IdleCond = NULL;	// MDFNAW_Flush() waits for the writer.
+
+static int Writer_ThreadMain(void *data)
+{
+ MDFND_LockMutex(Writer_Mutex);
+
+ for(;;)
+ {
+  while(Writer_Queue.empty() && !Writer_Quit)
+   MDFND_WaitCond(Writer_WorkCond, Writer_Mutex);
+
+  if(Writer_Queue.empty())
+   break;
+
+  Writer_Job job;
+
+  job.path.swap(Writer_Queue.front().path);
+  job.data.swap(Writer_Queue.front().data);
+  Writer_Queue.pop_front();
+  Writer_Busy = true;
+  MDFND_UnlockMutex(Writer_Mutex);
+
+  Writer_SaveFile(job.path, job.data);
+
+  MDFND_LockMutex(Writer_Mutex);
+  Writer_Busy = false;
+  MDFND_SignalCond(Writer_IdleCond);
+ }
+
+ MDFND_UnlockMutex(Writer_Mutex);
+
+ return 0;
+}
+
+static bool Writer_Start(void)
+{
+ if(Writer_Thread)
+  return true;
+
+ Writer_Mutex = MDFND_CreateMutex();
+ Writer_WorkCond = MDFND_CreateCond();
+ Writer_IdleCond = MDFND_CreateCond();
+ Writer_Quit = false;
+
+ if(Writer_Mutex && Writer_WorkCond && Writer_IdleCond && (Writer_Thread = MDFND_CreateThread(Writer_ThreadMain, NULL)))
+  return true;
+
+ if(Writer_IdleCond)
+  MDFND_DestroyCond(Writer_IdleCond);
+ if(Writer_WorkCond)
+  MDFND_DestroyCond(Writer_WorkCond);
+ if(Writer_Mutex)
+  MDFND_DestroyMutex(Writer_Mutex);
+
+ Writer_Mutex = NULL;
+ Writer_WorkCond = Writer_IdleCond = NULL;
+
+ return false;
+}
+#endif
+
+void MDFNAW_Write(const char *path, const void *data, uint32 size)
+{
+#ifdef WANT_THREADING
+ if(Writer_Start())
+ {
+  const uint8 *p = (const uint8 *)data;
+  Writer_Job *job = NULL;
+
+  MDFND_LockMutex(Writer_Mutex);
+
+  for(std::deque<Writer_Job>::iterator it = Writer_Queue.begin(); it != Writer_Queue.end(); it++)
+  {
+   if(it->path == path)
+   {
+    job = &*it;
+    break;
+   }
+  }
+
+  if(!job)
+  {
+   Writer_Queue.push_back(Writer_Job());
+   job = &Writer_Queue.back();
+   job->path = path;
+  }
+
+  job->data.assign(p, p + size);
+
+  MDFND_SignalCond(Writer_WorkCond);
+  MDFND_UnlockMutex(Writer_Mutex);
+  return;
+ }
+#endif
+
+ // No thread; write it now.
+ {
+  const uint8 *p = (const uint8 *)data;
+
+  Writer_SaveFile(path, std::vector<uint8>(p, p + size));
+ }
+}
+
+void MDFNAW_Flush(void)
+{
+#ifdef WANT_THREADING
+ if(!Writer_Thread)
+  return;
+
+ MDFND_LockMutex(Writer_Mutex);
+
+ while(!Writer_Queue.empty() || Writer_Busy)
+  MDFND_WaitCond(Writer_IdleCond, Writer_Mutex);
+
+ MDFND_UnlockMutex(Writer_Mutex);
+#endif
+}
+
+void MDFNAW_Kill(void)
+{
+#ifdef WANT_THREADING
+ if(!Writer_Thread)
+  return;
+
+ MDFNAW_Flush();
+
+ MDFND_LockMutex(Writer_Mutex);
+ Writer_Quit = true;
+ MDFND_SignalCond(Writer_WorkCond);
+ MDFND_UnlockMutex(Writer_Mutex);
+
+ MDFND_WaitThread(Writer_Thread, NULL);
+ Writer_Thread = NULL;
+
+ MDFND_DestroyCond(Writer_IdleCond);
+ MDFND_DestroyCond(Writer_WorkCond);
+ MDFND_DestroyMutex(Writer_Mutex);
+ Writer_Mutex = NULL;
+ Writer_WorkCond = Writer_IdleCond = NULL;
+#endif
+}
@@ -0,0 +1,21 @@
+#ifndef __MDFN_ASYNC_WRITER_H
+#define __MDFN_ASYNC_WRITER_H
+
+#include "mednafen-types.h"
+
+// Writes whole files on a background thread, so that slow or networked storage can't stall
+// emulation.  Each file is replaced atomically: the data goes to "<path>.tmp", which is then
+// renamed over the original, so a crash mid-write leaves the previous version intact.
+// Without WANT_THREADING, writes happen in the calling thread.
+
+// Queues size bytes of data(copied) to be written to path.  A queued write to the same path
+// that hasn't started yet is replaced rather than written twice.
+void MDFNAW_Write(const char *path, const void *data, uint32 size);
+
+// Waits until every write queued so far is finished.
+void MDFNAW_Flush(void);
+
+// Flushes, then stops the writer thread(it's restarted by the next MDFNAW_Write()).
+void MDFNAW_Kill(void);
+
+#endif
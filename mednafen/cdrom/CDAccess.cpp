@@ -28,6 +28,17 @@
 #include "CDAccess.h"
 #include "CDAccess_Image.h"
 #include "CDAccess_CCD.h"
+#include "CDAccess_Memory.h"
+#ifdef HAVE_CHD
+#include "CDAccess_CHD.h"
+#endif
+#ifdef HAVE_ZLIB
+#include "CDAccess_PBP.h"
+#endif
+
+#include "../../libretro.h"
+
+extern retro_log_printf_t log_cb;
 
 using namespace CDUtility;
 
@@ -41,10 +52,45 @@ CDAccess::~CDAccess()
 
 }
 
-CDAccess *cdaccess_open_image(const char *path, bool image_memcache)
+CDAccess *cdaccess_open_image(const char *path, bool image_memcache, unsigned disc)
 {
+ CDAccess *ret;
+
  if(strlen(path) >= 4 && !strcasecmp(path + strlen(path) - 4, ".ccd"))
-  return new CDAccess_CCD(path, image_memcache);
+  ret = new CDAccess_CCD(path, image_memcache);
+#ifdef HAVE_CHD
+ else if(strlen(path) >= 4 && !strcasecmp(path + strlen(path) - 4, ".chd"))
+  ret = new CDAccess_CHD(path, image_memcache);
+#endif
+#ifdef HAVE_ZLIB
+ else if(strlen(path) >= 4 && !strcasecmp(path + strlen(path) - 4, ".pbp"))
+  ret = new CDAccess_PBP(path, image_memcache, disc);
+#endif
+ else
+  ret = new CDAccess_Image(path, image_memcache);
+
+ if(image_memcache)
+ {
+  try
+  {
+   return new CDAccess_Memory(ret);
+  }
+  catch(std::exception &e)
+  {
+   if (log_cb)
+    log_cb(RETRO_LOG_WARN, "%s  Reading the disc from the image instead.\n", e.what());
+  }
+ }
+
+ return ret;
+}
+
+unsigned cdaccess_get_disc_count(const char *path)
+{
+#ifdef HAVE_ZLIB
+ if(strlen(path) >= 4 && !strcasecmp(path + strlen(path) - 4, ".pbp"))
+  return CDAccess_PBP::GetDiscCount(path);
+#endif
 
- return new CDAccess_Image(path, image_memcache);
+ return 1;
 }
@@ -23,6 +23,7 @@ class CDAccess
       CDAccess& operator=(const CDAccess&); // No assignment operator.
 };
 
-CDAccess *cdaccess_open_image(const char *path, bool image_memcache);
+CDAccess *cdaccess_open_image(const char *path, bool image_memcache, unsigned disc = 0);
+unsigned cdaccess_get_disc_count(const char *path);
 
 #endif
@@ -339,7 +339,7 @@ case 1:
  {
   std::string image_path = MDFN_EvalFIP(dir_path, file_base + std::string(".") + std::string(img_extsd), true);
 
-  img_stream = new FileStream(image_path.c_str(), FileStream::MODE_READ);
+  img_stream = MDFN_OpenReadStream(image_path.c_str());
 
   int64 ss = img_stream->size();
 
@@ -354,7 +354,7 @@ case 1:
  {
   std::string sub_path = MDFN_EvalFIP(dir_path, file_base + std::string(".") + std::string(sub_extsd), true);
 
-  sub_stream = new FileStream(sub_path.c_str(), FileStream::MODE_READ);
+  sub_stream = MDFN_OpenReadStream(sub_path.c_str());
 
   if(sub_stream->size() != (int64)img_numsectors * 96)
    throw MDFN_Error(0, _("CCD SUB file size mismatch."));
@@ -20,6 +20,7 @@
 
 #include "../FileStream.h"
 #include "../MemoryStream.h"
+#include "../MMapStream.h"
 #include "CDAccess.h"
 
 #include <vector>
@@ -0,0 +1,346 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ Notes:
+
+	Every CD frame in a CHD is stored as 2352 bytes of sector data followed by 96 bytes of subchannel data, regardless
+	of the track type; cooked(2048/2336/...) track types store their user data at the start of those 2352 bytes.
+
+	Each track is padded out to a multiple of 4 frames in the CHD.
+
+	Audio is stored big-endian.
+
+	The stored subchannel data is ignored; P and Q are simulated by CDAccess_Image::MakeSubPQ(), like with CUE sheets.
+
+	There's no prefetching in here; with threading enabled, CDIF's read-ahead thread calls Read_Raw_Sector() ahead of
+	the emulator, which decompresses upcoming hunks off of the emulation thread.
+*/
+
+#include "../mednafen.h"
+#include "../error.h"
+#include "../settings.h"
+
+#include <string.h>
+
+#include <libchdr/chd.h>
+
+#include "CDAccess.h"
+#include "CDAccess_CHD.h"
+#include "CDUtility.h"
+
+#include "../../libretro.h"
+
+extern retro_log_printf_t log_cb;
+
+using namespace CDUtility;
+
+enum
+{
+ CHD_CD_FRAME_SIZE = 2352 + 96,
+ CHD_CD_TRACK_PADDING = 4
+};
+
+static const struct
+{
+ const char *name;
+ uint32 DIFormat;
+} CHD_TrackTypes[] =
+{
+ { "AUDIO", DI_FORMAT_AUDIO },
+ { "MODE1", DI_FORMAT_MODE1 },
+ { "MODE1_RAW", DI_FORMAT_MODE1_RAW },
+ { "MODE2", DI_FORMAT_MODE2 },
+ { "MODE2_FORM1", DI_FORMAT_MODE2_FORM1 },
+ { "MODE2_FORM2", DI_FORMAT_MODE2_FORM2 },
+ { "MODE2_FORM_MIX", DI_FORMAT_MODE2 },
+ { "MODE2_RAW", DI_FORMAT_MODE2_RAW },
+};
+
+CDAccess_CHD::CDAccess_CHD(const char *path, bool image_memcache) : chd(NULL), hunk_bytes(0), total_hunks(0), frames_per_hunk(0), hunk_cache_clock(0), hunk_cache_last(0)
+{
+ chd_error err = chd_open(path, CHD_OPEN_READ, NULL, &chd);
+
+ if(err != CHDERR_NONE)
+  throw(MDFN_Error(0, _("Error opening CHD \"%s\": %s"), path, chd_error_string(err)));
+
+ try
+ {
+  const chd_header *head = chd_get_header(chd);
+
+  hunk_bytes = head->hunkbytes;
+  total_hunks = head->totalhunks;
+
+  if(!hunk_bytes || (hunk_bytes % CHD_CD_FRAME_SIZE))
+   throw(MDFN_Error(0, _("CHD hunk size %u isn't a multiple of the CD frame size; not a CD image?"), hunk_bytes));
+
+  frames_per_hunk = hunk_bytes / CHD_CD_FRAME_SIZE;
+
+  ParseTrackMetadata();
+
+  uint64 cache_hunks = MDFN_GetSettingUI("cdrom.chd_hunk_cache");
+
+  if(cache_hunks < 1)
+   cache_hunks = 1;
+
+  if(cache_hunks > total_hunks)
+   cache_hunks = total_hunks;
+
+  hunk_cache.resize(cache_hunks);
+
+  for(unsigned i = 0; i < hunk_cache.size(); i++)
+  {
+   hunk_cache[i].hunk = ~0U;
+   hunk_cache[i].last_use = 0;
+   hunk_cache[i].data.resize(hunk_bytes);
+  }
+ }
+ catch(...)
+ {
+  chd_close(chd);
+  chd = NULL;
+  throw;
+ }
+}
+
+CDAccess_CHD::~CDAccess_CHD()
+{
+ if(chd)
+  chd_close(chd);
+ chd = NULL;
+}
+
+void CDAccess_CHD::ParseTrackMetadata(void)
+{
+ int32 RunningLBA = 0;
+ uint32 chd_frame = 0;
+
+ FirstTrack = 1;
+ LastTrack = 0;
+ disc_type = DISC_TYPE_CDDA_OR_M1;
+
+ for(int x = 1; x <= 99; x++)
+ {
+  char meta[256];
+  char type[64], subtype[64], pgtype[64], pgsub[64];
+  int tracknum = 0, frames = 0, pregap = 0, postgap = 0;
+  uint32 meta_len = 0;
+  bool found_type = false;
+
+  type[0] = subtype[0] = pgtype[0] = pgsub[0] = 0;
+
+  if(chd_get_metadata(chd, CDROM_TRACK_METADATA2_TAG, x - 1, meta, sizeof(meta) - 1, &meta_len, NULL, NULL) == CHDERR_NONE)
+  {
+   meta[std::min<uint32>(meta_len, sizeof(meta) - 1)] = 0;
+
+   if(sscanf(meta, "TRACK:%d TYPE:%63s SUBTYPE:%63s FRAMES:%d PREGAP:%d PGTYPE:%63s PGSUB:%63s POSTGAP:%d", &tracknum, type, subtype, &frames, &pregap, pgtype, pgsub, &postgap) != 8)
+    throw(MDFN_Error(0, _("Malformed CHD track metadata: %s"), meta));
+  }
+  else if(chd_get_metadata(chd, CDROM_TRACK_METADATA_TAG, x - 1, meta, sizeof(meta) - 1, &meta_len, NULL, NULL) == CHDERR_NONE)
+  {
+   meta[std::min<uint32>(meta_len, sizeof(meta) - 1)] = 0;
+
+   if(sscanf(meta, "TRACK:%d TYPE:%63s SUBTYPE:%63s FRAMES:%d", &tracknum, type, subtype, &frames) != 4)
+    throw(MDFN_Error(0, _("Malformed CHD track metadata: %s"), meta));
+  }
+  else
+   break;
+
+  if(tracknum != x)
+   throw(MDFN_Error(0, _("CHD track %d found where track %d was expected."), tracknum, x));
+
+  if(frames <= 0 || pregap < 0 || postgap < 0 || pregap > frames)
+   throw(MDFN_Error(0, _("Bad frame counts in CHD track %d metadata."), x));
+
+  CDRFILE_TRACK_INFO *ct = &Tracks[x];
+
+  for(unsigned i = 0; i < sizeof(CHD_TrackTypes) / sizeof(CHD_TrackTypes[0]); i++)
+  {
+   if(!strcmp(type, CHD_TrackTypes[i].name))
+   {
+    ct->DIFormat = CHD_TrackTypes[i].DIFormat;
+    found_type = true;
+    break;
+   }
+  }
+
+  if(!found_type)
+   throw(MDFN_Error(0, _("Unsupported CHD track type \"%s\"."), type));
+
+  if(ct->DIFormat == DI_FORMAT_AUDIO)
+   ct->subq_control &= ~SUBQ_CTRLF_DATA;
+  else
+   ct->subq_control |= SUBQ_CTRLF_DATA;
+
+  if(ct->DIFormat >= DI_FORMAT_MODE2)
+   disc_type = DISC_TYPE_CD_XA;
+
+  // A pregap type starting with 'V' means the pregap sectors are stored in the CHD(like INDEX 00 in a CUE sheet), and
+  // are included in the frame count; otherwise they're silence that isn't stored(like PREGAP in a CUE sheet).
+  if(pgtype[0] == 'V')
+   ct->pregap_dv = pregap;
+  else
+   ct->pregap = pregap;
+
+  ct->postgap = postgap;
+  ct->sectors = frames - ct->pregap_dv;
+  ct->FileOffset = chd_frame + ct->pregap_dv;	// In frames, of INDEX 01.
+
+  // Track 1's pregap is the 2 seconds before LBA 0, which we don't support reading.
+  if(x == 1)
+  {
+   ct->pregap = 0;
+   ct->pregap_dv = 0;
+  }
+
+  RunningLBA += ct->pregap + ct->pregap_dv;
+  ct->LBA = RunningLBA;
+  RunningLBA += ct->sectors + ct->postgap;
+
+  chd_frame += (frames + CHD_CD_TRACK_PADDING - 1) / CHD_CD_TRACK_PADDING * CHD_CD_TRACK_PADDING;
+
+  LastTrack = x;
+ }
+
+ if(FirstTrack > LastTrack)
+  throw(MDFN_Error(0, _("No tracks found!\n")));
+
+ if(chd_frame > (uint64)total_hunks * frames_per_hunk)
+  throw(MDFN_Error(0, _("CHD track metadata describes more frames than are stored.")));
+
+ NumTracks = 1 + LastTrack - FirstTrack;
+ total_sectors = RunningLBA;
+}
+
+const uint8 *CDAccess_CHD::ReadFrame(uint32 frame)
+{
+ const uint32 hunk = frame / frames_per_hunk;
+ const uint32 offset = (frame % frames_per_hunk) * CHD_CD_FRAME_SIZE;
+ HunkCacheEntry *ent = &hunk_cache[hunk_cache_last];
+
+ hunk_cache_clock++;
+
+ if(ent->hunk != hunk)
+ {
+  uint32 victim = 0;
+
+  ent = NULL;
+
+  for(uint32 i = 0; i < hunk_cache.size(); i++)
+  {
+   if(hunk_cache[i].hunk == hunk)
+   {
+    ent = &hunk_cache[i];
+    hunk_cache_last = i;
+    break;
+   }
+
+   if(hunk_cache[i].last_use < hunk_cache[victim].last_use)
+    victim = i;
+  }
+
+  if(!ent)
+  {
+   chd_error err;
+
+   ent = &hunk_cache[victim];
+   hunk_cache_last = victim;
+
+   if((err = chd_read(chd, hunk, &ent->data[0])) != CHDERR_NONE)
+   {
+    ent->hunk = ~0U;
+    ent->last_use = 0;
+    throw(MDFN_Error(0, _("Error reading CHD hunk %u: %s"), hunk, chd_error_string(err)));
+   }
+
+   ent->hunk = hunk;
+  }
+ }
+
+ ent->last_use = hunk_cache_clock;
+
+ return &ent->data[offset];
+}
+
+void CDAccess_CHD::Read_Raw_Sector(uint8 *buf, int32 lba)
+{
+ CDRFILE_TRACK_INFO *ct = NULL;
+
+ memset(buf + 2352, 0, 96);
+
+ MakeSubPQ(lba, buf + 2352);
+
+ for(int32 track = FirstTrack; track < (FirstTrack + NumTracks); track++)
+ {
+  if(lba >= (Tracks[track].LBA - Tracks[track].pregap_dv - Tracks[track].pregap) && lba < (Tracks[track].LBA + Tracks[track].sectors + Tracks[track].postgap))
+  {
+   ct = &Tracks[track];
+   break;
+  }
+ }
+
+ if(!ct)
+  throw(MDFN_Error(0, _("Could not find track for sector %u!"), lba));
+
+ // Pregap/postgap sectors that aren't stored are null sector data, per spec.
+ if(lba < (ct->LBA - ct->pregap_dv) || lba >= (ct->LBA + ct->sectors))
+ {
+  memset(buf, 0, 2352);
+  return;
+ }
+
+ const uint8 *frame = ReadFrame(ct->FileOffset + (lba - ct->LBA));
+
+ switch(ct->DIFormat)
+ {
+  case DI_FORMAT_AUDIO:
+	memcpy(buf, frame, 2352);
+	Endian_A16_Swap(buf, 588 * 2);
+	break;
+
+  case DI_FORMAT_MODE1_RAW:
+  case DI_FORMAT_MODE2_RAW:
+	memcpy(buf, frame, 2352);
+	break;
+
+  case DI_FORMAT_MODE1:
+	memset(buf, 0, 16);
+	memcpy(buf + 16, frame, 2048);
+#ifdef WANT_ECC
+	encode_mode1_sector(lba + 150, buf);
+#endif
+	break;
+
+  case DI_FORMAT_MODE2:
+	memset(buf, 0, 16);
+	memcpy(buf + 16, frame, 2336);
+#ifdef WANT_ECC
+	encode_mode2_sector(lba + 150, buf);
+#endif
+	break;
+
+  case DI_FORMAT_MODE2_FORM1:
+	memset(buf, 0, 24);
+	memcpy(buf + 24, frame, 2048);
+	break;
+
+  case DI_FORMAT_MODE2_FORM2:
+	memset(buf, 0, 24);
+	memcpy(buf + 24, frame, 2324);
+	break;
+ }
+}
@@ -0,0 +1,46 @@
+#ifndef __MDFN_CDACCESS_CHD_H
+#define __MDFN_CDACCESS_CHD_H
+
+#include "CDAccess_Image.h"
+
+#include <vector>
+
+struct _chd_file;
+
+// MAME CHD(compressed hunks of data) CD images, read through libchdr.
+//
+// Tracks are laid out the same way CDAccess_Image lays out a CUE sheet, so the TOC and the simulated P/Q subchannel
+// data come from the same code; only the sector data is read differently.
+class CDAccess_CHD : public CDAccess_Image
+{
+   public:
+
+      CDAccess_CHD(const char *path, bool image_memcache);
+      virtual ~CDAccess_CHD();
+
+      virtual void Read_Raw_Sector(uint8 *buf, int32 lba);
+
+   private:
+
+      struct HunkCacheEntry
+      {
+         uint32 hunk;		// ~0U when empty.
+         uint32 last_use;
+         std::vector<uint8> data;
+      };
+
+      _chd_file *chd;
+      uint32 hunk_bytes;
+      uint32 total_hunks;
+      uint32 frames_per_hunk;
+
+      // LRU cache of decompressed hunks.  Sized from the "cdrom.chd_hunk_cache" setting when the image is opened.
+      std::vector<HunkCacheEntry> hunk_cache;
+      uint32 hunk_cache_clock;
+      uint32 hunk_cache_last;	// Index of the most recently used entry; consecutive sectors nearly always share a hunk.
+
+      void ParseTrackMetadata(void);
+      const uint8 *ReadFrame(uint32 frame);
+};
+
+#endif
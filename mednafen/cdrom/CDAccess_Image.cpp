@@ -41,6 +41,7 @@
 
 #include "../general.h"
 #include "../FileStream.h"
+#include "../MMapStream.h"
 #include "../MemoryStream.h"
 
 #include "CDAccess.h"
@@ -64,19 +65,6 @@ enum
  CDRF_SUBM_RW_RAW = 2
 };
 
-// Disk-image(rip) track/sector formats
-enum
-{
- DI_FORMAT_AUDIO       = 0x00,
- DI_FORMAT_MODE1       = 0x01,
- DI_FORMAT_MODE1_RAW   = 0x02,
- DI_FORMAT_MODE2       = 0x03,
- DI_FORMAT_MODE2_FORM1 = 0x04,
- DI_FORMAT_MODE2_FORM2 = 0x05,
- DI_FORMAT_MODE2_RAW   = 0x06,
- _DI_FORMAT_COUNT
-};
-
 static const int32 DI_Size_Table[7] =
 {
  2352, // Audio
@@ -219,7 +207,7 @@ void CDAccess_Image::ParseTOCFileLineInfo(CDRFILE_TRACK_INFO *track, const int t
 
   efn = MDFN_EvalFIP(base_dir, filename);
 
-  track->fp = new FileStream(efn.c_str(), FileStream::MODE_READ);
+  track->fp = MDFN_OpenReadStream(efn.c_str());
 
   toc_streamcache[filename] = track->fp;
  }
@@ -551,7 +539,7 @@ void CDAccess_Image::ImageOpen(const char *path, bool image_memcache)
      }
 
      std::string efn = MDFN_EvalFIP(base_dir, args[0]);
-     TmpTrack.fp = new FileStream(efn.c_str(), FileStream::MODE_READ);
+     TmpTrack.fp = MDFN_OpenReadStream(efn.c_str());
      TmpTrack.FirstFileInstance = 1;
 
      if(!strcasecmp(args[1].c_str(), "BINARY"))
@@ -562,7 +550,8 @@ void CDAccess_Image::ImageOpen(const char *path, bool image_memcache)
       //TmpTrack.sectors = stat_buf.st_size; // / 2048;
      }
      else if(!strcasecmp(args[1].c_str(), "OGG") || !strcasecmp(args[1].c_str(), "VORBIS") || !strcasecmp(args[1].c_str(), "WAVE") || !strcasecmp(args[1].c_str(), "WAV") || !strcasecmp(args[1].c_str(), "PCM")
-	|| !strcasecmp(args[1].c_str(), "MPC") || !strcasecmp(args[1].c_str(), "MP+"))
+	|| !strcasecmp(args[1].c_str(), "MPC") || !strcasecmp(args[1].c_str(), "MP+") || !strcasecmp(args[1].c_str(), "FLAC") || !strcasecmp(args[1].c_str(), "WAVPACK")
+	|| !strcasecmp(args[1].c_str(), "WV"))
      {
       TmpTrack.AReader = AR_Open(TmpTrack.fp);
       if(!TmpTrack.AReader)
@@ -825,6 +814,11 @@ CDAccess_Image::CDAccess_Image(const char *path, bool image_memcache) : NumTrack
  ImageOpen(path, image_memcache);
 }
 
+CDAccess_Image::CDAccess_Image(void) : NumTracks(0), FirstTrack(0), LastTrack(0), total_sectors(0), disc_type(DISC_TYPE_CDDA_OR_M1)
+{
+ memset(Tracks, 0, sizeof(Tracks));
+}
+
 CDAccess_Image::~CDAccess_Image()
 {
  Cleanup();
@@ -6,6 +6,19 @@
 class Stream;
 class AudioReader;
 
+// Disk-image(rip) track/sector formats
+enum
+{
+ DI_FORMAT_AUDIO       = 0x00,
+ DI_FORMAT_MODE1       = 0x01,
+ DI_FORMAT_MODE1_RAW   = 0x02,
+ DI_FORMAT_MODE2       = 0x03,
+ DI_FORMAT_MODE2_FORM1 = 0x04,
+ DI_FORMAT_MODE2_FORM2 = 0x05,
+ DI_FORMAT_MODE2_RAW   = 0x06,
+ _DI_FORMAT_COUNT
+};
+
 struct CDRFILE_TRACK_INFO
 {
    int32 LBA;
@@ -44,7 +57,10 @@ class CDAccess_Image : public CDAccess
       virtual void Read_TOC(CDUtility::TOC *toc);
 
       virtual void Eject(bool eject_status);
-   private:
+   protected:
+
+      // For loaders of other image formats that fill in Tracks[] themselves and reuse the TOC/subchannel code.
+      CDAccess_Image(void);
 
       int32 NumTracks;
       int32 FirstTrack;
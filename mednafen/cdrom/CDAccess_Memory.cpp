@@ -0,0 +1,140 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "../mednafen.h"
+#include "../error.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "CDAccess.h"
+#include "CDAccess_Memory.h"
+
+#include "../../libretro.h"
+
+extern retro_log_printf_t log_cb;
+extern struct retro_perf_callback perf_cb;
+
+using namespace CDUtility;
+
+enum { MEMORY_SECTOR_SIZE = 2352 + 96 };
+
+CDAccess_Memory::CDAccess_Memory(CDAccess *source_) : source(source_), sectors(NULL), num_sectors(0), alloced(0)
+{
+   const retro_time_t start_usec = perf_cb.get_time_usec ? perf_cb.get_time_usec() : 0;
+
+   try
+   {
+      uint64 size;
+
+      source->Read_TOC(&toc);
+
+      num_sectors = toc.tracks[100].lba;
+      size = (uint64)num_sectors * MEMORY_SECTOR_SIZE;
+
+      if(size > SIZE_MAX)
+         throw(MDFN_Error(0, _("Disc image is too large to load into memory.")));
+
+      alloced = size;
+
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+      // Anonymous mapping rather than malloc() so the kernel can back it with transparent huge pages, which
+      // keeps TLB misses down when the emulator seeks around a ~700MiB buffer.
+      {
+         void *p = mmap(NULL, alloced, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+         if(p != MAP_FAILED)
+         {
+            sectors = (uint8 *)p;
+#ifdef MADV_HUGEPAGE
+            madvise(p, alloced, MADV_HUGEPAGE);
+#endif
+         }
+      }
+#else
+      sectors = (uint8 *)malloc(alloced);
+#endif
+
+      if(!sectors && alloced)
+         throw(MDFN_Error(ENOMEM, _("Not enough memory to load the disc into RAM(%.1f MiB needed)."), (double)alloced / (1024 * 1024)));
+
+      for(uint32 lba = 0; lba < num_sectors; lba++)
+         source->Read_Raw_Sector(&sectors[(uint64)lba * MEMORY_SECTOR_SIZE], lba);
+   }
+   catch(...)
+   {
+      Free();
+      source = NULL;
+      throw;
+   }
+
+   if (log_cb)
+   {
+      if (perf_cb.get_time_usec)
+         log_cb(RETRO_LOG_INFO, "Loaded disc into RAM: %u sectors, %.1f MiB, in %u ms.\n", num_sectors, (double)alloced / (1024 * 1024), (unsigned)((perf_cb.get_time_usec() - start_usec) / 1000));
+      else
+         log_cb(RETRO_LOG_INFO, "Loaded disc into RAM: %u sectors, %.1f MiB.\n", num_sectors, (double)alloced / (1024 * 1024));
+   }
+}
+
+CDAccess_Memory::~CDAccess_Memory()
+{
+   Free();
+
+   if(source)
+      delete source;
+   source = NULL;
+}
+
+void CDAccess_Memory::Free(void)
+{
+   if(!sectors)
+      return;
+
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+   munmap(sectors, alloced);
+#else
+   free(sectors);
+#endif
+   sectors = NULL;
+}
+
+void CDAccess_Memory::Read_Raw_Sector(uint8 *buf, int32 lba)
+{
+   // Anything outside of the program area(pregap of track 1, leadout) is left to the image code.
+   if(lba < 0 || (uint32)lba >= num_sectors)
+   {
+      source->Read_Raw_Sector(buf, lba);
+      return;
+   }
+
+   memcpy(buf, &sectors[(uint64)lba * MEMORY_SECTOR_SIZE], MEMORY_SECTOR_SIZE);
+}
+
+void CDAccess_Memory::Read_TOC(TOC *toc_out)
+{
+   *toc_out = toc;
+}
+
+void CDAccess_Memory::Eject(bool eject_status)
+{
+   source->Eject(eject_status);
+}
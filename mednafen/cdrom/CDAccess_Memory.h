@@ -0,0 +1,34 @@
+#ifndef __MDFN_CDACCESS_MEMORY_H
+#define __MDFN_CDACCESS_MEMORY_H
+
+#include "CDAccess.h"
+
+// Reads a whole disc(sector data and subchannel, audio tracks decoded) from another CDAccess into one
+// contiguous buffer up front, so that later reads never touch the disc image.
+class CDAccess_Memory : public CDAccess
+{
+   public:
+
+      // Takes ownership of "source" on success; throws(leaving "source" to the caller) if the disc can't be preloaded.
+      CDAccess_Memory(CDAccess *source);
+      virtual ~CDAccess_Memory();
+
+      virtual void Read_Raw_Sector(uint8 *buf, int32 lba);
+
+      virtual void Read_TOC(CDUtility::TOC *toc);
+
+      virtual void Eject(bool eject_status);
+
+   private:
+
+      CDAccess *source;
+      CDUtility::TOC toc;
+
+      uint8 *sectors;		// (2352 + 96) bytes for each of LBA 0 through num_sectors - 1.
+      uint32 num_sectors;
+      uint64 alloced;
+
+      void Free(void);
+};
+
+#endif
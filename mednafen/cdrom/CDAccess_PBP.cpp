@@ -0,0 +1,352 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ Notes:
+
+	Layout(all values little-endian):
+	 0x0000		"\0PBP", version, then 8 section offsets; the last one(at 0x24) is DATA.PSAR.
+	 DATA.PSAR	"PSISOIMG0000" for a single disc, or "PSTITLEIMG000000" followed at +0x200 by up to 5 offsets(relative
+			to DATA.PSAR) of each disc's "PSISOIMG0000" header.
+
+	Per disc, relative to its PSISOIMG header:
+	 0x0800		TOC, as 10-byte lead-in Q entries: ctrl/adr, tno, point, min, sec, frame, zero, pmin, psec, pframe(BCD).
+			Points A0, A1 and A2 come first; min/sec/frame of the track entries is the track's index 0 time, and
+			pmin/psec/pframe its index 1 time.  The sector stream holds the whole disc from LBA 0, pregaps included,
+			so it's addressed by LBA rather than by either of those.
+	 0x4000		Block index, 32-byte entries: offset(relative to 0x100000), length(16-bit), then don't-care bytes.  A zero
+			length ends the table.
+	 0x100000	Blocks of 16 raw 2352-byte sectors; raw deflate unless the stored length is the full block size.
+
+	There's no prefetching in here; with threading enabled, CDIF's read-ahead thread calls Read_Raw_Sector() ahead of
+	the emulator, which inflates upcoming blocks off of the emulation thread.
+*/
+
+#include "../mednafen.h"
+#include "../error.h"
+#include "../FileStream.h"
+#include "../MMapStream.h"
+
+#include <string.h>
+
+#include <zlib.h>
+
+#include "CDAccess.h"
+#include "CDAccess_PBP.h"
+#include "CDUtility.h"
+
+using namespace CDUtility;
+
+enum
+{
+ PBP_MAX_DISCS = 5,
+ PBP_TOC_OFFSET = 0x800,
+ PBP_INDEX_OFFSET = 0x4000,
+ PBP_BLOCKS_OFFSET = 0x100000,
+ PBP_INDEX_ENTRY_SIZE = 32
+};
+
+// Returns the file offset of disc "disc"'s PSISOIMG header, and the number of discs in *disc_count.
+static uint64 PBP_FindDisc(Stream *fp, unsigned disc, unsigned *disc_count)
+{
+ uint8 header[0x28];
+ uint8 sig[16];
+ uint64 psar_offset, iso_offset;
+
+ fp->seek(0, SEEK_SET);
+
+ if(fp->read(header, sizeof(header)) != sizeof(header) || memcmp(header, "\0PBP", 4))
+  throw(MDFN_Error(0, _("Not a PBP file.")));
+
+ psar_offset = iso_offset = MDFN_de32lsb(header + 0x24);
+
+ fp->seek(psar_offset, SEEK_SET);
+
+ if(fp->read(sig, sizeof(sig)) != sizeof(sig))
+  throw(MDFN_Error(0, _("PBP file is truncated.")));
+
+ *disc_count = 1;
+
+ if(!memcmp(sig, "PSTITLEIMG", 10))
+ {
+  uint8 disc_offsets[PBP_MAX_DISCS * 4];
+
+  fp->seek(psar_offset + 0x200, SEEK_SET);
+
+  if(fp->read(disc_offsets, sizeof(disc_offsets)) != sizeof(disc_offsets))
+   throw(MDFN_Error(0, _("PBP file is truncated.")));
+
+  for(*disc_count = 0; *disc_count < PBP_MAX_DISCS && MDFN_de32lsb(disc_offsets + *disc_count * 4); (*disc_count)++);
+
+  if(disc < *disc_count)
+  {
+   iso_offset = psar_offset + MDFN_de32lsb(disc_offsets + disc * 4);
+
+   fp->seek(iso_offset, SEEK_SET);
+
+   if(fp->read(sig, sizeof(sig)) != sizeof(sig))
+    throw(MDFN_Error(0, _("PBP file is truncated.")));
+  }
+ }
+
+ if(disc >= *disc_count)
+  throw(MDFN_Error(0, _("PBP file doesn't contain disc %u."), disc + 1));
+
+ if(memcmp(sig, "PSISOIMG00", 10))
+  throw(MDFN_Error(0, _("Unsupported PBP file; no PlayStation disc image found.")));
+
+ return iso_offset;
+}
+
+unsigned CDAccess_PBP::GetDiscCount(const char *path)
+{
+ FileStream fs(path, FileStream::MODE_READ);
+ unsigned disc_count;
+
+ PBP_FindDisc(&fs, 0, &disc_count);
+
+ return disc_count;
+}
+
+CDAccess_PBP::CDAccess_PBP(const char *path, bool image_memcache, unsigned disc) : fp(NULL), zs(NULL), block_cache(NULL)
+{
+ try
+ {
+  unsigned disc_count;
+  uint64 iso_base;
+
+  fp = MDFN_OpenReadStream(path);
+
+  iso_base = PBP_FindDisc(fp, disc, &disc_count);
+
+  ParseTOC(iso_base);
+  ParseIndex(iso_base);
+
+  zs = calloc(1, sizeof(z_stream));
+
+  if(!zs || inflateInit2((z_stream *)zs, -MAX_WBITS) != Z_OK)
+  {
+   free(zs);
+   zs = NULL;
+   throw(MDFN_Error(0, _("Error initializing zlib.")));
+  }
+
+  block_cache = new CachedBlock[BLOCK_CACHE_SIZE];
+
+  for(unsigned i = 0; i < BLOCK_CACHE_SIZE; i++)
+   block_cache[i].block = ~0U;
+ }
+ catch(...)
+ {
+  Close();
+  throw;
+ }
+}
+
+CDAccess_PBP::~CDAccess_PBP()
+{
+ Close();
+}
+
+void CDAccess_PBP::Close(void)
+{
+ if(block_cache)
+  delete[] block_cache;
+ block_cache = NULL;
+
+ if(zs)
+ {
+  inflateEnd((z_stream *)zs);
+  free(zs);
+ }
+ zs = NULL;
+
+ if(fp)
+  delete fp;
+ fp = NULL;
+}
+
+void CDAccess_PBP::ParseTOC(uint64 iso_base)
+{
+ uint8 entry[10];
+ int32 leadout_lba = 0;
+ unsigned num_tracks = 0;
+
+ fp->seek(iso_base + PBP_TOC_OFFSET, SEEK_SET);
+
+ // Points A0(first track), A1(last track), A2(leadout).
+ for(unsigned i = 0; i < 3; i++)
+ {
+  if(fp->read(entry, sizeof(entry)) != sizeof(entry))
+   throw(MDFN_Error(0, _("PBP file is truncated.")));
+
+  if(entry[2] == 0xA1)
+   num_tracks = BCD_to_U8(entry[7]);
+  else if(entry[2] == 0xA2)
+   leadout_lba = AMSF_to_LBA(BCD_to_U8(entry[7]), BCD_to_U8(entry[8]), BCD_to_U8(entry[9]));
+ }
+
+ if(num_tracks < 1 || num_tracks > 99)
+  throw(MDFN_Error(0, _("PBP TOC has a bad track count(%u)."), num_tracks));
+
+ FirstTrack = 1;
+ LastTrack = num_tracks;
+ NumTracks = num_tracks;
+ disc_type = DISC_TYPE_CDDA_OR_M1;
+
+ for(unsigned x = 1; x <= num_tracks; x++)
+ {
+  CDRFILE_TRACK_INFO *ct = &Tracks[x];
+
+  if(fp->read(entry, sizeof(entry)) != sizeof(entry))
+   throw(MDFN_Error(0, _("PBP file is truncated.")));
+
+  if(entry[0] & (SUBQ_CTRLF_DATA << 4))
+  {
+   ct->DIFormat = DI_FORMAT_MODE2_RAW;
+   ct->subq_control = SUBQ_CTRLF_DATA;
+   disc_type = DISC_TYPE_CD_XA;
+  }
+  else
+  {
+   ct->DIFormat = DI_FORMAT_AUDIO;
+   ct->subq_control = 0;
+  }
+
+  ct->LBA = AMSF_to_LBA(BCD_to_U8(entry[7]), BCD_to_U8(entry[8]), BCD_to_U8(entry[9]));
+
+  if(x > 1)
+   Tracks[x - 1].sectors = ct->LBA - Tracks[x - 1].LBA;
+ }
+
+ Tracks[num_tracks].sectors = leadout_lba - Tracks[num_tracks].LBA;
+
+ for(unsigned x = 1; x <= num_tracks; x++)
+ {
+  if(Tracks[x].sectors <= 0)
+   throw(MDFN_Error(0, _("PBP TOC has bad track positions.")));
+ }
+
+ // The 2 seconds before LBA 0 aren't stored.  Treating them as track 1's pregap gives them the right
+ // subchannel Q, and Read_Raw_Sector() makes null sector data for them.
+ Tracks[FirstTrack].pregap = Tracks[FirstTrack].LBA + 150;
+
+ total_sectors = leadout_lba;
+}
+
+void CDAccess_PBP::ParseIndex(uint64 iso_base)
+{
+ const uint64 blocks_base = iso_base + PBP_BLOCKS_OFFSET;
+ uint8 entry[PBP_INDEX_ENTRY_SIZE];
+
+ fp->seek(iso_base + PBP_INDEX_OFFSET, SEEK_SET);
+
+ for(unsigned i = 0; i < (PBP_BLOCKS_OFFSET - PBP_INDEX_OFFSET) / PBP_INDEX_ENTRY_SIZE; i++)
+ {
+  uint32 length;
+
+  if(fp->read(entry, sizeof(entry)) != sizeof(entry))
+   break;
+
+  if(!(length = MDFN_de16lsb(entry + 4)))
+   break;
+
+  if(length > BLOCK_SIZE)
+   throw(MDFN_Error(0, _("PBP block %u has a bad length(%u)."), i, length));
+
+  block_offset.push_back(blocks_base + MDFN_de32lsb(entry + 0));
+  block_length.push_back(length);
+ }
+
+ if(block_offset.empty())
+  throw(MDFN_Error(0, _("PBP block index is empty.")));
+
+ comp_buf.resize(BLOCK_SIZE);
+}
+
+const uint8 *CDAccess_PBP::ReadBlock(uint32 block)
+{
+ CachedBlock *cb = &block_cache[block & (BLOCK_CACHE_SIZE - 1)];
+
+ if(cb->block == block)
+  return cb->data;
+
+ cb->block = ~0U;
+
+ fp->seek(block_offset[block], SEEK_SET);
+
+ if(block_length[block] == BLOCK_SIZE)
+ {
+  if(fp->read(cb->data, BLOCK_SIZE) != BLOCK_SIZE)
+   throw(MDFN_Error(0, _("PBP block %u is truncated."), block));
+ }
+ else
+ {
+  z_stream *z = (z_stream *)zs;
+  int zerr;
+
+  if(fp->read(&comp_buf[0], block_length[block]) != block_length[block])
+   throw(MDFN_Error(0, _("PBP block %u is truncated."), block));
+
+  inflateReset(z);
+  z->next_in = &comp_buf[0];
+  z->avail_in = block_length[block];
+  z->next_out = cb->data;
+  z->avail_out = BLOCK_SIZE;
+
+  zerr = inflate(z, Z_FINISH);
+
+  // The last block of a disc can be short.
+  if(zerr != Z_STREAM_END && !(zerr == Z_BUF_ERROR && (block + 1) == block_offset.size()))
+   throw(MDFN_Error(0, _("Error decompressing PBP block %u."), block));
+
+  memset(z->next_out, 0, z->avail_out);
+ }
+
+ cb->block = block;
+
+ return cb->data;
+}
+
+void CDAccess_PBP::Read_Raw_Sector(uint8 *buf, int32 lba)
+{
+ memset(buf + 2352, 0, 96);
+
+ MakeSubPQ(lba, buf + 2352);
+
+ if(lba < (Tracks[FirstTrack].LBA - Tracks[FirstTrack].pregap) || lba >= total_sectors)
+  throw(MDFN_Error(0, _("Could not find track for sector %u!"), lba));
+
+ // Pregap sectors that aren't stored are null sector data, per spec, as in CDAccess_Image and CDAccess_CHD.
+ if(lba < 0)
+ {
+  memset(buf, 0, 2352);
+  return;
+ }
+
+ const uint32 sector = lba;
+ const uint32 block = sector / BLOCK_SECTORS;
+
+ // Some tools don't store trailing blocks that would be all zeroes.
+ if(block >= block_offset.size())
+ {
+  memset(buf, 0, 2352);
+  return;
+ }
+
+ memcpy(buf, ReadBlock(block) + (sector % BLOCK_SECTORS) * 2352, 2352);
+}
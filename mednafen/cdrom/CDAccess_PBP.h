@@ -0,0 +1,54 @@
+#ifndef __MDFN_CDACCESS_PBP_H
+#define __MDFN_CDACCESS_PBP_H
+
+#include "CDAccess_Image.h"
+
+#include <vector>
+
+// PSP "eboot" PBP images made by popstation and friends: one or more discs, each stored as 16-sector blocks of raw
+// 2352-byte sectors, compressed with raw deflate.
+//
+// Like CDAccess_CHD, this fills in CDAccess_Image's track layout so the TOC and P/Q subchannel simulation are shared.
+class CDAccess_PBP : public CDAccess_Image
+{
+   public:
+
+      CDAccess_PBP(const char *path, bool image_memcache, unsigned disc);
+      virtual ~CDAccess_PBP();
+
+      virtual void Read_Raw_Sector(uint8 *buf, int32 lba);
+
+      // Returns the number of discs stored in the PBP at "path".
+      static unsigned GetDiscCount(const char *path);
+
+   private:
+
+      enum
+      {
+         BLOCK_SECTORS = 16,
+         BLOCK_SIZE = BLOCK_SECTORS * 2352,
+         BLOCK_CACHE_SIZE = 16		// Power of 2; direct-mapped on block number.
+      };
+
+      struct CachedBlock
+      {
+         uint32 block;		// ~0U when empty.
+         uint8 data[BLOCK_SIZE];
+      };
+
+      Stream *fp;
+      void *zs;			// z_stream; kept opaque so zlib.h doesn't leak out of CDAccess_PBP.cpp.
+
+      std::vector<uint64> block_offset;	// Absolute file offset of each block.
+      std::vector<uint32> block_length;	// Stored length; BLOCK_SIZE means the block isn't compressed.
+      std::vector<uint8> comp_buf;
+
+      CachedBlock *block_cache;
+
+      void Close(void);
+      void ParseTOC(uint64 iso_base);
+      void ParseIndex(uint64 iso_base);
+      const uint8 *ReadBlock(uint32 block);
+};
+
+#endif
@@ -31,21 +31,114 @@
 #include "audioreader_opus.h"
 #endif
 
+#ifdef HAVE_FLAC
+#include "audioreader_flac.h"
+#endif
+
+#ifdef HAVE_WAVPACK
+#include "audioreader_wavpack.h"
+#endif
+
 #include <string.h>
+#include <stdlib.h>
+#include <algorithm>
 #include <errno.h>
 #include <time.h>
 
 #include "../general.h"
 #include "../mednafen-endian.h"
+#include "../error.h"
+#include "../../libretro.h"
+
+extern retro_log_printf_t log_cb;
 
-AudioReader::AudioReader() : LastReadPos(0)
+AudioReader::AudioReader() : LastReadPos(0), Cache(NULL), CacheStart(0), CacheEnd(0)
 {
 
 }
 
 AudioReader::~AudioReader()
 {
+ if(Cache)
+  free(Cache);
+ Cache = NULL;
+}
+
+// Decodes up to max_frames more frames at CacheEnd, dropping the oldest frames from the window to make room.
+bool AudioReader::Fill(int64 max_frames)
+{
+ const int64 ring_pos = CacheEnd % CACHE_FRAMES;
+ int64 frames = std::min<int64>(max_frames, CACHE_FRAMES - ring_pos);	// Don't wrap within one Read_().
+ int64 got;
+
+ got = Read_(Cache + ring_pos * 2, frames);
+
+ if(got <= 0)
+  return(false);
+
+ LastReadPos += got;
+ CacheEnd += got;
+
+ if((CacheEnd - CacheStart) > CACHE_FRAMES)
+  CacheStart = CacheEnd - CACHE_FRAMES;
+
+ return(true);
+}
+
+int64 AudioReader::Read(int64 frame_offset, int16 *buffer, int64 frames)
+{
+ int64 ret = 0;
+
+ if(!Cache)
+ {
+  if(!(Cache = (int16 *)malloc(CACHE_FRAMES * 2 * sizeof(int16))))
+   return(0);
+ }
+
+ while(frames > 0)
+ {
+  if(frame_offset >= CacheStart && frame_offset < CacheEnd)
+  {
+   const int64 ring_pos = frame_offset % CACHE_FRAMES;
+   const int64 count = std::min<int64>(std::min<int64>(frames, CacheEnd - frame_offset), CACHE_FRAMES - ring_pos);
+
+   memcpy(buffer, Cache + ring_pos * 2, count * 2 * sizeof(int16));
+
+   buffer += count * 2;
+   frame_offset += count;
+   frames -= count;
+   ret += count;
+   continue;
+  }
+
+  // A read that picks up where the cached window ends just keeps decoding, in bigger chunks; anything else seeks and
+  // starts a new window.
+  if(frame_offset != CacheEnd || CacheStart == CacheEnd)
+  {
+   if(LastReadPos != frame_offset)
+   {
+    //puts("SEEK");
+    if(!Seek_(frame_offset))
+    {
+     // Where the decoder ended up is anyone's guess, so make the next read seek again rather than trust it or the
+     // cached window.
+     LastReadPos = -1;
+     CacheStart = CacheEnd = 0;
+     break;
+    }
+    LastReadPos = frame_offset;
+   }
+
+   CacheStart = CacheEnd = frame_offset;
+
+   if(!Fill(frames))
+    break;
+  }
+  else if(!Fill(std::max<int64>(frames, DECODE_CHUNK_FRAMES)))
+   break;
+ }
 
+ return(ret);
 }
 
 int64 AudioReader::Read_(int16 *buffer, int64 frames)
@@ -198,6 +291,37 @@ int64 OggVorbisReader::FrameCount(void)
 
 AudioReader *AR_Open(Stream *fp)
 {
+#ifdef HAVE_FLAC
+ try
+ {
+  return new FLACReader(fp);
+ }
+ catch(int i)
+ {
+ }
+ catch(MDFN_Error &e)
+ {
+  // Recognized but unusable; let the remaining readers have a go.
+  if(log_cb)
+   log_cb(RETRO_LOG_WARN, "%s\n", e.what());
+ }
+#endif
+
+#ifdef HAVE_WAVPACK
+ try
+ {
+  return new WavPackReader(fp);
+ }
+ catch(int i)
+ {
+ }
+ catch(MDFN_Error &e)
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_WARN, "%s\n", e.what());
+ }
+#endif
+
 #ifdef HAVE_OPUSFILE
  try
  {
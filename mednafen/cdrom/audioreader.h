@@ -11,30 +11,27 @@ class AudioReader
 
  virtual int64 FrameCount(void);
 
- INLINE int64 Read(int64 frame_offset, int16 *buffer, int64 frames)
- {
-    int64 ret;
-
-    //if(frame_offset >= 0)
-    {
-       if(LastReadPos != frame_offset)
-       {
-          //puts("SEEK");
-          if(!Seek_(frame_offset))
-             return(0);
-          LastReadPos = frame_offset;
-       }
-    }
-    ret = Read_(buffer, frames);
-    LastReadPos += ret;
-    return(ret);
- }
+ // Decoded frames are kept in a ring covering the last CACHE_FRAMES frames decoded, so re-reading anything in that window
+ // doesn't touch the decoder, and sequential reads decode several sectors' worth at a time.
+ int64 Read(int64 frame_offset, int16 *buffer, int64 frames);
 
  private:
  virtual int64 Read_(int16 *buffer, int64 frames);
  virtual bool Seek_(int64 frame_offset);
 
- int64 LastReadPos;
+ enum
+ {
+  CACHE_FRAMES = 588 * 75,	// One second of CD-DA.
+  DECODE_CHUNK_FRAMES = 588 * 8	// Decoded per Read_() call while reading sequentially.
+ };
+
+ bool Fill(int64 max_frames);
+
+ int64 LastReadPos;		// Decoder position; always CacheEnd once the cache is in use, -1 after a failed seek.
+
+ int16 *Cache;			// CACHE_FRAMES stereo frames; frame N lives at N % CACHE_FRAMES.
+ int64 CacheStart;		// Cached window, [CacheStart, CacheEnd).
+ int64 CacheEnd;
 };
 
 // AR_Open(), and AudioReader, will NOT take "ownership" of the Stream object(IE it won't ever delete it).  Though it does assume it has exclusive access
@@ -0,0 +1,439 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ Seeking:
+
+	libFLAC's own seeking bisects the file(or uses the seek table, if the encoder wrote a useful one), which costs several
+	reads and decodes per seek.  Instead, the frame headers are scanned when the file is opened(no decoding needed; each
+	candidate is checked against its CRC-8 and for a plausible frame/sample number), and Seek_() repositions the stream at
+	the frame containing the target sample, flushes the decoder, and throws away the samples before the target.  For
+	fixed-blocksize streams(what every common encoder produces) finding the frame is a division.
+*/
+
+#include "../mednafen.h"
+#include "../error.h"
+#include "audioreader.h"
+#include "audioreader_flac.h"
+
+#include <string.h>
+#include <algorithm>
+
+enum
+{
+ FLAC_MAX_FRAME_HEADER = 16,
+ FLAC_MIN_FRAME_SIZE = 10,	// Header, one constant subframe, CRC-16.
+ FLAC_MAX_BLOCKSIZE = 65535,
+ FLAC_SCAN_CHUNK = 65536
+};
+
+static FLAC__StreamDecoderReadStatus iflac_read_func(const FLAC__StreamDecoder *decoder, FLAC__byte buffer[], size_t *bytes, void *user_data)
+{
+ Stream *fw = ((FLACReader *)user_data)->fw;
+
+ if(!*bytes)
+  return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+
+ *bytes = fw->read(buffer, *bytes, false);
+
+ return *bytes ? FLAC__STREAM_DECODER_READ_STATUS_CONTINUE : FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+}
+
+static FLAC__StreamDecoderSeekStatus iflac_seek_func(const FLAC__StreamDecoder *decoder, FLAC__uint64 absolute_byte_offset, void *user_data)
+{
+ Stream *fw = ((FLACReader *)user_data)->fw;
+
+ fw->seek(absolute_byte_offset, SEEK_SET);
+ return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
+}
+
+static FLAC__StreamDecoderTellStatus iflac_tell_func(const FLAC__StreamDecoder *decoder, FLAC__uint64 *absolute_byte_offset, void *user_data)
+{
+ Stream *fw = ((FLACReader *)user_data)->fw;
+
+ *absolute_byte_offset = fw->tell();
+ return FLAC__STREAM_DECODER_TELL_STATUS_OK;
+}
+
+static FLAC__StreamDecoderLengthStatus iflac_length_func(const FLAC__StreamDecoder *decoder, FLAC__uint64 *stream_length, void *user_data)
+{
+ Stream *fw = ((FLACReader *)user_data)->fw;
+
+ *stream_length = fw->size();
+ return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
+}
+
+static FLAC__bool iflac_eof_func(const FLAC__StreamDecoder *decoder, void *user_data)
+{
+ Stream *fw = ((FLACReader *)user_data)->fw;
+
+ return fw->tell() >= fw->size();
+}
+
+static FLAC__StreamDecoderWriteStatus iflac_write_func(const FLAC__StreamDecoder *decoder, const FLAC__Frame *frame, const FLAC__int32 *const buffer[], void *user_data)
+{
+ ((FLACReader *)user_data)->Write(frame, buffer);
+ return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+static void iflac_metadata_func(const FLAC__StreamDecoder *decoder, const FLAC__StreamMetadata *metadata, void *user_data)
+{
+ ((FLACReader *)user_data)->Metadata(metadata);
+}
+
+static void iflac_error_func(const FLAC__StreamDecoder *decoder, FLAC__StreamDecoderErrorStatus status, void *user_data)
+{
+ // Lost sync/bad CRC; libFLAC resyncs on its own, and there's nothing better to do with a damaged frame.
+}
+
+static uint8 FLAC_CRC8(const uint8 *data, unsigned len)
+{
+ uint8 crc = 0;
+
+ while(len--)
+ {
+  crc ^= *data++;
+
+  for(unsigned b = 0; b < 8; b++)
+   crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+ }
+
+ return crc;
+}
+
+// Checks for a valid frame header at p; on success, returns the frame number(fixed blocksize) or sample number(variable
+// blocksize) in *number.
+static bool FLAC_ParseFrameHeader(const uint8 *p, size_t avail, bool *variable, uint64 *number)
+{
+ unsigned len = 4;
+ unsigned extra;
+ uint64 num;
+
+ if(avail < FLAC_MAX_FRAME_HEADER)
+  return false;
+
+ if(p[0] != 0xFF || (p[1] & 0xFE) != 0xF8)
+  return false;
+
+ if(!(p[2] >> 4) || (p[2] & 0x0F) == 0x0F)		// Reserved block size, invalid sample rate.
+  return false;
+
+ if((p[3] >> 4) >= 0x0B || ((p[3] >> 1) & 0x7) == 3 || (p[3] & 1))	// Reserved channel assignment/sample size/bit.
+  return false;
+
+ // UTF-8-style coded number.
+ if(!(p[len] & 0x80))
+ {
+  num = p[len];
+  extra = 0;
+ }
+ else
+ {
+  unsigned lead = 0;
+
+  while(lead < 8 && (p[len] & (0x80 >> lead)))
+   lead++;
+
+  if(lead < 2 || lead > 7)
+   return false;
+
+  num = (lead == 7) ? 0 : (p[len] & (0x7F >> lead));
+  extra = lead - 1;
+ }
+ len++;
+
+ for(unsigned i = 0; i < extra; i++, len++)
+ {
+  if((p[len] & 0xC0) != 0x80)
+   return false;
+
+  num = (num << 6) | (p[len] & 0x3F);
+ }
+
+ switch(p[2] >> 4)
+ {
+  case 6: len += 1; break;
+  case 7: len += 2; break;
+ }
+
+ switch(p[2] & 0x0F)
+ {
+  case 12: len += 1; break;
+  case 13:
+  case 14: len += 2; break;
+ }
+
+ if(FLAC_CRC8(p, len) != p[len])
+  return false;
+
+ *variable = p[1] & 1;
+ *number = num;
+
+ return true;
+}
+
+FLACReader::FLACReader(Stream *fp) : fw(fp), decoder(NULL), total_samples(0), sample_rate(0), channels(0), bits_per_sample(0), fixed_blocksize(0), min_framesize(0), pending_pos(0), skip(0)
+{
+ uint8 magic[4];
+ FLAC__uint64 first_frame_offset = 0;
+
+ fp->seek(0, SEEK_SET);
+
+ if(fp->read(magic, 4, false) != 4 || (memcmp(magic, "fLaC", 4) && memcmp(magic, "ID3", 3)))
+  throw(0);
+
+ fp->seek(0, SEEK_SET);
+
+ if(!(decoder = FLAC__stream_decoder_new()))
+  throw MDFN_Error(0, _("Error creating FLAC decoder."));
+
+ if(FLAC__stream_decoder_init_stream(decoder, iflac_read_func, iflac_seek_func, iflac_tell_func, iflac_length_func, iflac_eof_func,
+	iflac_write_func, iflac_metadata_func, iflac_error_func, this) != FLAC__STREAM_DECODER_INIT_STATUS_OK)
+ {
+  FLAC__stream_decoder_delete(decoder);
+  throw MDFN_Error(0, _("Error initializing FLAC decoder."));
+ }
+
+ if(!FLAC__stream_decoder_process_until_end_of_metadata(decoder) || !sample_rate || !FLAC__stream_decoder_get_decode_position(decoder, &first_frame_offset))
+ {
+  FLAC__stream_decoder_delete(decoder);
+  throw(0);
+ }
+
+ if(bits_per_sample < 4 || bits_per_sample > 24)
+ {
+  FLAC__stream_decoder_delete(decoder);
+  throw MDFN_Error(0, _("Unsupported FLAC sample size: %u bits."), bits_per_sample);
+ }
+
+ BuildIndex(first_frame_offset);
+
+ if(!Seek_(0))
+ {
+  FLAC__stream_decoder_delete(decoder);
+  throw MDFN_Error(0, _("FLAC file has no audio frames."));
+ }
+}
+
+FLACReader::~FLACReader()
+{
+ FLAC__stream_decoder_delete(decoder);
+}
+
+void FLACReader::Metadata(const FLAC__StreamMetadata *metadata)
+{
+ if(metadata->type != FLAC__METADATA_TYPE_STREAMINFO)
+  return;
+
+ total_samples = metadata->data.stream_info.total_samples;
+ sample_rate = metadata->data.stream_info.sample_rate;
+ channels = metadata->data.stream_info.channels;
+ bits_per_sample = metadata->data.stream_info.bits_per_sample;
+ min_framesize = metadata->data.stream_info.min_framesize;
+
+ if(metadata->data.stream_info.min_blocksize == metadata->data.stream_info.max_blocksize)
+  fixed_blocksize = metadata->data.stream_info.max_blocksize;
+}
+
+void FLACReader::Write(const FLAC__Frame *frame, const FLAC__int32 *const buffer[])
+{
+ const unsigned count = frame->header.blocksize;
+ const unsigned bps = frame->header.bits_per_sample;
+ const FLAC__int32 *left = buffer[0];
+ const FLAC__int32 *right = buffer[(frame->header.channels >= 2) ? 1 : 0];
+
+ pending.resize(count * 2);
+ pending_pos = 0;
+
+ for(unsigned i = 0; i < count; i++)
+ {
+  if(bps >= 16)
+  {
+   pending[i * 2 + 0] = left[i] >> (bps - 16);
+   pending[i * 2 + 1] = right[i] >> (bps - 16);
+  }
+  else
+  {
+   pending[i * 2 + 0] = left[i] * (1 << (16 - bps));	// Not a shift; samples can be negative.
+   pending[i * 2 + 1] = right[i] * (1 << (16 - bps));
+  }
+ }
+}
+
+void FLACReader::BuildIndex(uint64 first_frame_offset)
+{
+ std::vector<uint8> buf(FLAC_SCAN_CHUNK + FLAC_MAX_FRAME_HEADER);
+ uint64 buf_offset = first_frame_offset;	// File offset of buf[0].
+ size_t buf_len = 0;
+ bool eof = false;
+
+ fw->seek(first_frame_offset, SEEK_SET);
+
+ while(!eof || buf_len)
+ {
+  size_t scan_end;
+  size_t i = 0;
+
+  if(!eof)
+  {
+   const size_t want = buf.size() - buf_len;
+   const size_t got = fw->read(&buf[buf_len], want, false);
+
+   buf_len += got;
+   eof = (got < want);
+  }
+
+  scan_end = eof ? buf_len : (buf_len - FLAC_MAX_FRAME_HEADER);
+
+  while(i < scan_end)
+  {
+   bool variable;
+   uint64 number;
+
+   if(buf[i] == 0xFF && FLAC_ParseFrameHeader(&buf[i], buf_len - i, &variable, &number))
+   {
+    IndexEntry ent;
+
+    ent.offset = buf_offset + i;
+    ent.first_sample = variable ? number : number * fixed_blocksize;
+
+    // The frame must come after the last one indexed(or the start), by no more frames than could fit in the bytes in
+    // between.  That weeds out sync codes and CRCs that happen to match inside of compressed data, while a damaged
+    // frame just leaves a gap in the index(see Seek_()).
+    bool plausible = false;
+
+    if(variable || fixed_blocksize)
+    {
+     const uint64 prev_offset = index.empty() ? first_frame_offset : index.back().offset;
+     const uint64 max_frames = (ent.offset - prev_offset) / std::max<unsigned>(min_framesize, FLAC_MIN_FRAME_SIZE);
+     const uint64 max_samples = max_frames * (variable ? FLAC_MAX_BLOCKSIZE : fixed_blocksize);
+
+     if(index.empty())
+      plausible = (ent.first_sample <= max_samples);
+     else
+      plausible = (ent.first_sample > index.back().first_sample && (ent.first_sample - index.back().first_sample) <= max_samples);
+    }
+
+    if(plausible)
+    {
+     index.push_back(ent);
+     i += std::max<unsigned>(min_framesize, 1);
+     continue;
+    }
+   }
+   i++;
+  }
+
+  if(eof)
+   break;
+
+  if(i >= buf_len)
+  {
+   // Skipped past the buffered data(min_framesize jump).
+   fw->seek(i - buf_len, SEEK_CUR);
+   buf_offset += i;
+   buf_len = 0;
+  }
+  else
+  {
+   memmove(&buf[0], &buf[i], buf_len - i);
+   buf_offset += i;
+   buf_len -= i;
+  }
+ }
+}
+
+int64 FLACReader::Read_(int16 *buffer, int64 frames)
+{
+ int64 ret = 0;
+
+ while(frames > 0)
+ {
+  const size_t avail = pending.size() / 2 - pending_pos;
+
+  if(avail)
+  {
+   if(skip)
+   {
+    const size_t count = (size_t)std::min<uint64>(skip, avail);
+
+    pending_pos += count;
+    skip -= count;
+   }
+   else
+   {
+    const size_t count = (size_t)std::min<int64>(frames, avail);
+
+    memcpy(buffer, &pending[pending_pos * 2], count * 2 * sizeof(int16));
+    buffer += count * 2;
+    pending_pos += count;
+    frames -= count;
+    ret += count;
+   }
+   continue;
+  }
+
+  if(FLAC__stream_decoder_get_state(decoder) == FLAC__STREAM_DECODER_END_OF_STREAM)
+   break;
+
+  pending.clear();
+  pending_pos = 0;
+
+  if(!FLAC__stream_decoder_process_single(decoder))
+   break;
+ }
+
+ return(ret);
+}
+
+bool FLACReader::Seek_(int64 frame_offset)
+{
+ size_t i;
+
+ if(index.empty() || frame_offset < 0)
+  return(false);
+
+ i = fixed_blocksize ? (size_t)std::min<uint64>(frame_offset / fixed_blocksize, index.size() - 1) : index.size();
+
+ if(i >= index.size() || index[i].first_sample > (uint64)frame_offset)
+ {
+  // Variable blocksize, or a gap in the index from a damaged frame.
+  i = 0;
+
+  for(size_t step = index.size(); step; step >>= 1)
+  {
+   while((i + step) < index.size() && index[i + step].first_sample <= (uint64)frame_offset)
+    i += step;
+  }
+ }
+
+ fw->seek(index[i].offset, SEEK_SET);
+
+ if(!FLAC__stream_decoder_flush(decoder))
+  return(false);
+
+ pending.clear();
+ pending_pos = 0;
+ skip = frame_offset - index[i].first_sample;
+
+ return(true);
+}
+
+int64 FLACReader::FrameCount(void)
+{
+ return(total_samples);
+}
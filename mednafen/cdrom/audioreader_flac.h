@@ -0,0 +1,48 @@
+#ifndef __MDFN_AUDIOREADER_FLAC_H
+#define __MDFN_AUDIOREADER_FLAC_H
+
+#include <FLAC/stream_decoder.h>
+
+#include <vector>
+
+class FLACReader : public AudioReader
+{
+   public:
+      FLACReader(Stream *fp);
+      ~FLACReader();
+
+      int64 Read_(int16 *buffer, int64 frames);
+      bool Seek_(int64 frame_offset);
+      int64 FrameCount(void);
+
+      // Called from the libFLAC callbacks.
+      void Metadata(const FLAC__StreamMetadata *metadata);
+      void Write(const FLAC__Frame *frame, const FLAC__int32 *const buffer[]);
+      Stream *fw;
+
+   private:
+      struct IndexEntry
+      {
+         uint64 offset;		// Byte offset of the frame header.
+         uint64 first_sample;
+      };
+
+      void BuildIndex(uint64 first_frame_offset);
+
+      FLAC__StreamDecoder *decoder;
+
+      uint64 total_samples;
+      unsigned sample_rate;
+      unsigned channels;
+      unsigned bits_per_sample;
+      unsigned fixed_blocksize;	// 0 if the stream uses variable block sizes.
+      unsigned min_framesize;
+
+      std::vector<IndexEntry> index;
+
+      std::vector<int16> pending;	// Decoded stereo frames from the last FLAC frame...
+      size_t pending_pos;		// ...and how many of them have been returned(or skipped) so far.
+      uint64 skip;			// Frames still to be thrown away after a seek into the middle of a FLAC frame.
+};
+
+#endif
@@ -0,0 +1,188 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ WavPack blocks each carry their starting sample index, so the library's own WavpackSeekSample64() already gets to the
+ right block by bisecting the file without decoding anything; no separate index is needed here, unlike FLACReader.
+*/
+
+#include "../mednafen.h"
+#include "../error.h"
+#include "audioreader.h"
+#include "audioreader_wavpack.h"
+
+#include <string.h>
+#include <algorithm>
+
+enum
+{
+ WAVPACK_UNPACK_FRAMES = 4096
+};
+
+static int32_t iwv_read_bytes(void *id, void *data, int32_t bcount)
+{
+ return ((Stream *)id)->read(data, bcount, false);
+}
+
+static int32_t iwv_write_bytes(void *id, void *data, int32_t bcount)
+{
+ return 0;
+}
+
+static int64_t iwv_get_pos(void *id)
+{
+ return ((Stream *)id)->tell();
+}
+
+static int iwv_set_pos_abs(void *id, int64_t pos)
+{
+ ((Stream *)id)->seek(pos, SEEK_SET);
+ return 0;
+}
+
+static int iwv_set_pos_rel(void *id, int64_t delta, int mode)
+{
+ ((Stream *)id)->seek(delta, mode);
+ return 0;
+}
+
+static int iwv_push_back_byte(void *id, int c)
+{
+ ((Stream *)id)->seek(-1, SEEK_CUR);
+ return c;
+}
+
+static int64_t iwv_get_length(void *id)
+{
+ return ((Stream *)id)->size();
+}
+
+static int iwv_can_seek(void *id)
+{
+ return 1;
+}
+
+static WavpackStreamReader64 iwv_reader =
+{
+ iwv_read_bytes,
+ iwv_write_bytes,
+ iwv_get_pos,
+ iwv_set_pos_abs,
+ iwv_set_pos_rel,
+ iwv_push_back_byte,
+ iwv_get_length,
+ iwv_can_seek,
+ NULL,	// truncate_here
+ NULL	// close
+};
+
+WavPackReader::WavPackReader(Stream *fp) : wpc(NULL), fw(fp), channels(0), shift(0)
+{
+ char error[81];
+ uint8 magic[4];
+ unsigned bits;
+
+ fp->seek(0, SEEK_SET);
+
+ if(fp->read(magic, 4, false) != 4 || memcmp(magic, "wvpk", 4))
+  throw(0);
+
+ fp->seek(0, SEEK_SET);
+
+ if(!(wpc = WavpackOpenFileInputEx64(&iwv_reader, fp, NULL, error, OPEN_2CH_MAX, 0)))
+  throw MDFN_Error(0, _("Error opening WavPack file: %s"), error);
+
+ if(WavpackGetMode(wpc) & MODE_FLOAT)
+ {
+  WavpackCloseFile(wpc);
+  throw MDFN_Error(0, _("Floating-point WavPack files are not supported."));
+ }
+
+ bits = WavpackGetBytesPerSample(wpc) * 8;
+ shift = (bits > 16) ? (bits - 16) : 0;
+ channels = WavpackGetReducedChannels(wpc);
+
+ if(!channels || WavpackGetBytesPerSample(wpc) < 2)
+ {
+  WavpackCloseFile(wpc);
+  throw MDFN_Error(0, _("Unsupported WavPack sample format."));
+ }
+
+ unpack_buf.resize(WAVPACK_UNPACK_FRAMES * channels);
+}
+
+WavPackReader::~WavPackReader()
+{
+ if(wpc)
+  WavpackCloseFile(wpc);
+}
+
+int64 WavPackReader::Read_(int16 *buffer, int64 frames)
+{
+ int64 ret = 0;
+
+ if(!wpc)
+  return(0);
+
+ while(frames > 0)
+ {
+  const uint32_t want = (uint32_t)std::min<int64>(frames, WAVPACK_UNPACK_FRAMES);
+  const uint32_t got = WavpackUnpackSamples(wpc, &unpack_buf[0], want);
+
+  for(uint32_t i = 0; i < got; i++)
+  {
+   const int32_t *s = &unpack_buf[i * channels];
+
+   buffer[0] = s[0] >> shift;
+   buffer[1] = s[(channels >= 2) ? 1 : 0] >> shift;
+   buffer += 2;
+  }
+
+  ret += got;
+  frames -= got;
+
+  if(got < want)
+   break;
+ }
+
+ return(ret);
+}
+
+bool WavPackReader::Seek_(int64 frame_offset)
+{
+ char error[81];
+
+ if(!wpc)
+  return(false);
+
+ if(WavpackSeekSample64(wpc, frame_offset))
+  return(true);
+
+ // A failed seek leaves the context unusable, so start over on a fresh one(back at sample 0).  Reporting the failure
+ // makes AudioReader::Read() drop its position and cached window, so its next call seeks again instead of reading on
+ // from the start of the track.
+ WavpackCloseFile(wpc);
+ fw->seek(0, SEEK_SET);
+ wpc = WavpackOpenFileInputEx64(&iwv_reader, fw, NULL, error, OPEN_2CH_MAX, 0);
+
+ return(false);
+}
+
+int64 WavPackReader::FrameCount(void)
+{
+ return WavpackGetNumSamples64(wpc);
+}
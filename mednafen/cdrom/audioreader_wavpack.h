@@ -0,0 +1,27 @@
+#ifndef __MDFN_AUDIOREADER_WAVPACK_H
+#define __MDFN_AUDIOREADER_WAVPACK_H
+
+#include <wavpack/wavpack.h>
+
+#include <vector>
+
+class WavPackReader : public AudioReader
+{
+   public:
+      WavPackReader(Stream *fp);
+      ~WavPackReader();
+
+      int64 Read_(int16 *buffer, int64 frames);
+      bool Seek_(int64 frame_offset);
+      int64 FrameCount(void);
+
+   private:
+      WavpackContext *wpc;		// NULL if reopening after a failed seek didn't work.
+      Stream *fw;
+
+      unsigned channels;		// Channels per unpacked frame(at most 2, see OPEN_2CH_MAX).
+      unsigned shift;			// Bits to shift right to get down to 16-bit samples.
+      std::vector<int32_t> unpack_buf;
+};
+
+#endif
@@ -20,17 +20,42 @@
 #include <string.h>
 #include <sys/types.h>
 #include "cdromif.h"
+#include "CDAccess_Memory.h"
 #include "../general.h"
 
 #include <algorithm>
+#ifdef WANT_THREADING
+#include <queue>
+#endif
 #include "../../libretro.h"
 
 extern retro_log_printf_t log_cb;
 
 #ifdef WANT_ECC
 using namespace CDUtility;
+
+//
+// Verification results, 2 bits per LBA in CDIF::ecc_status.  Sectors that needed L-EC repair are kept(corrected) in a
+// small LBA-indexed cache so a re-read doesn't redo the correction; if one's been evicted, it's simply checked again.
+//
+enum
+{
+ CDIF_ECC_UNCHECKED = 0,
+ CDIF_ECC_GOOD,		// EDC matched as read.
+ CDIF_ECC_REPAIRED,	// EDC matched after L-EC.
+ CDIF_ECC_BAD,		// Uncorrectable.
+
+ CDIF_REPAIR_CACHE_SIZE = 16	// Power of 2; direct-mapped on LBA.
+};
 #endif
 
+struct CDIF_RepairedSector
+{
+ uint32 lba;
+ bool valid;
+ uint8 data[2352];
+};
+
 enum
 {
  // Status/Error messages
@@ -50,6 +75,247 @@ enum
  CDIF_MSG_EJECT,		// Emu -> read, args[0]; 0=insert, 1=eject
 };
 
+#ifdef WANT_THREADING
+//
+// Read-ahead: a worker thread reads the sectors following the last one the emulator asked for into a small LBA-indexed cache,
+// so a slow fseek()/fread() on the image happens off the emulation thread.  CDIF_ReadRawSector() still doesn't return until the
+// requested sector is available(reading it itself on a miss), so sector data and emulated timing don't depend on I/O speed.
+//
+enum
+{
+ CDIF_RA_CACHE_SIZE = 256,	// Power of 2; direct-mapped on LBA.
+ CDIF_RA_AHEAD = 96		// Sectors to keep prefetched past the last one read(about 0.6 seconds at 2x).
+};
+
+struct CDIF_Message
+{
+ unsigned message;
+ uint32 arg;
+};
+
+struct CDIF_CachedSector
+{
+ uint32 lba;
+ bool valid;
+ uint8 data[2352 + 96];
+};
+
+struct CDIF_ReadAhead
+{
+ MDFN_Thread *thread;
+ MDFN_Mutex *mutex;	// Protects everything below, and disc_cdaccess while the thread is running.
+ MDFN_Cond *work_cond;	// Emu -> read: new message posted.
+ MDFN_Cond *done_cond;	// Read -> emu: a sector read finished.
+
+ std::queue<CDIF_Message> messages;
+
+ bool busy;		// Read thread is in Read_Raw_Sector(busy_lba) with the mutex released.
+ uint32 busy_lba;
+
+ uint32 next_lba;	// Prefetch window, [next_lba, end_lba).
+ uint32 end_lba;
+
+ CDIF_CachedSector sectors[CDIF_RA_CACHE_SIZE];
+};
+
+// Call with ra->mutex held.
+static void CDIF_RA_Post(CDIF_ReadAhead *ra, unsigned message, uint32 arg)
+{
+ CDIF_Message msg;
+
+ msg.message = message;
+ msg.arg = arg;
+
+ ra->messages.push(msg);
+ MDFND_SignalCond(ra->work_cond);
+}
+
+// Call with ra->mutex held.  Also drops the READ_SECTOR messages still queued, which would otherwise restart the
+// prefetch on what's now a different disc(or none).
+static void CDIF_RA_Invalidate(CDIF_ReadAhead *ra)
+{
+ std::queue<CDIF_Message> keep;
+
+ for(unsigned i = 0; i < CDIF_RA_CACHE_SIZE; i++)
+  ra->sectors[i].valid = false;
+
+ ra->next_lba = ra->end_lba = 0;
+
+ for(; !ra->messages.empty(); ra->messages.pop())
+ {
+  if(ra->messages.front().message != CDIF_MSG_READ_SECTOR)
+   keep.push(ra->messages.front());
+ }
+
+ ra->messages.swap(keep);
+}
+
+static int CDIF_RA_ThreadMain(void *data)
+{
+ CDIF *cdif = (CDIF *)data;
+ CDIF_ReadAhead *ra = cdif->ra;
+ uint8 buf[2352 + 96];
+
+ MDFND_LockMutex(ra->mutex);
+
+ for(;;)
+ {
+  while(!ra->messages.empty())
+  {
+   const CDIF_Message msg = ra->messages.front();
+
+   ra->messages.pop();
+
+   switch(msg.message)
+   {
+    case CDIF_MSG_DIEDIEDIE:
+     MDFND_UnlockMutex(ra->mutex);
+     return 0;
+
+    case CDIF_MSG_READ_SECTOR:
+     // Keep what's already been prefetched if the emulator is still reading inside the window.
+     if(ra->next_lba < msg.arg || ra->next_lba > (msg.arg + CDIF_RA_AHEAD))
+      ra->next_lba = msg.arg;
+
+     ra->end_lba = std::min<uint32>(msg.arg + CDIF_RA_AHEAD, cdif->disc_toc.tracks[100].lba);
+     break;
+   }
+  }
+
+  if(ra->next_lba < ra->end_lba)
+  {
+   const uint32 lba = ra->next_lba++;
+   CDIF_CachedSector *sect = &ra->sectors[lba & (CDIF_RA_CACHE_SIZE - 1)];
+   bool ok = true;
+
+   if(sect->valid && sect->lba == lba)
+    continue;
+
+   ra->busy = true;
+   ra->busy_lba = lba;
+   MDFND_UnlockMutex(ra->mutex);
+
+   try
+   {
+    cdif->disc_cdaccess->Read_Raw_Sector(buf, lba);
+   }
+   catch(...)
+   {
+    // Leave it to the emulator's own read of this sector to report the error.
+    ok = false;
+   }
+
+   MDFND_LockMutex(ra->mutex);
+   ra->busy = false;
+
+   if(ok)
+   {
+    memcpy(sect->data, buf, sizeof(buf));
+    sect->lba = lba;
+    sect->valid = true;
+   }
+   else
+    ra->end_lba = ra->next_lba;
+
+   MDFND_SignalCond(ra->done_cond);
+   continue;
+  }
+
+  MDFND_WaitCond(ra->work_cond, ra->mutex);
+ }
+}
+
+static void CDIF_RA_Start(CDIF *cdif)
+{
+ CDIF_ReadAhead *ra = new CDIF_ReadAhead;
+
+ ra->mutex = MDFND_CreateMutex();
+ ra->work_cond = MDFND_CreateCond();
+ ra->done_cond = MDFND_CreateCond();
+ ra->busy = false;
+ ra->busy_lba = 0;
+ CDIF_RA_Invalidate(ra);
+
+ if(ra->mutex && ra->work_cond && ra->done_cond)
+ {
+  cdif->ra = ra;
+
+  if((ra->thread = MDFND_CreateThread(CDIF_RA_ThreadMain, cdif)))
+   return;
+
+  cdif->ra = NULL;
+ }
+
+ if (log_cb)
+  log_cb(RETRO_LOG_WARN, "Could not start CD read-ahead thread; reading synchronously.\n");
+
+ if(ra->done_cond)
+  MDFND_DestroyCond(ra->done_cond);
+ if(ra->work_cond)
+  MDFND_DestroyCond(ra->work_cond);
+ if(ra->mutex)
+  MDFND_DestroyMutex(ra->mutex);
+ delete ra;
+}
+
+static void CDIF_RA_Stop(CDIF *cdif)
+{
+ CDIF_ReadAhead *ra = cdif->ra;
+
+ MDFND_LockMutex(ra->mutex);
+ CDIF_RA_Post(ra, CDIF_MSG_DIEDIEDIE, 0);
+ MDFND_UnlockMutex(ra->mutex);
+
+ MDFND_WaitThread(ra->thread, NULL);
+
+ MDFND_DestroyCond(ra->done_cond);
+ MDFND_DestroyCond(ra->work_cond);
+ MDFND_DestroyMutex(ra->mutex);
+ delete ra;
+
+ cdif->ra = NULL;
+}
+
+static void CDIF_RA_ReadRawSector(CDIF *cdif, uint8 *buf, uint32 lba)
+{
+ CDIF_ReadAhead *ra = cdif->ra;
+ CDIF_CachedSector *sect = &ra->sectors[lba & (CDIF_RA_CACHE_SIZE - 1)];
+
+ MDFND_LockMutex(ra->mutex);
+
+ while(ra->busy && ra->busy_lba == lba)
+  MDFND_WaitCond(ra->done_cond, ra->mutex);
+
+ if(sect->valid && sect->lba == lba)
+  memcpy(buf, sect->data, 2352 + 96);
+ else
+ {
+  // Miss; read it here, once the thread is out of disc_cdaccess.
+  while(ra->busy)
+   MDFND_WaitCond(ra->done_cond, ra->mutex);
+
+  try
+  {
+   cdif->disc_cdaccess->Read_Raw_Sector(buf, lba);
+  }
+  catch(...)
+  {
+   MDFND_UnlockMutex(ra->mutex);
+   throw;
+  }
+
+  memcpy(sect->data, buf, 2352 + 96);
+  sect->lba = lba;
+  sect->valid = true;
+ }
+
+ if(lba < (uint32)cdif->disc_toc.tracks[100].lba)
+  CDIF_RA_Post(ra, CDIF_MSG_READ_SECTOR, lba + 1);
+
+ MDFND_UnlockMutex(ra->mutex);
+}
+#endif
+
 CDIF *CDIF_New(CDAccess *cda)
 {
    CDIF *cdif = (CDIF*)calloc(1, sizeof(CDIF));
@@ -71,19 +337,43 @@ CDIF *CDIF_New(CDAccess *cda)
       return NULL;
    }
 
+#ifdef WANT_ECC
+   cdif->ecc_status_count = cdif->disc_toc.tracks[100].lba;
+   cdif->ecc_status = (uint8*)calloc((cdif->ecc_status_count + 3) >> 2, 1);
+   cdif->repaired = (CDIF_RepairedSector*)calloc(CDIF_REPAIR_CACHE_SIZE, sizeof(CDIF_RepairedSector));
+
+   if(!cdif->ecc_status || !cdif->repaired)
+   {
+      free(cdif->ecc_status);
+      free(cdif->repaired);
+      free(cdif);
+      return NULL;
+   }
+#endif
+
    return cdif;
 }
 
 void CDIF_Free(CDIF *cdif)
 {
+   if(!cdif)
+      return;
+
+#ifdef WANT_THREADING
+   if(cdif->ra)
+      CDIF_RA_Stop(cdif);
+#endif
+
    if(cdif->disc_cdaccess)
       delete cdif->disc_cdaccess;
    cdif->disc_cdaccess = NULL;
 
+   free(cdif->ecc_status);
+   free(cdif->repaired);
    free(cdif);
 }
 
-bool CDIF_ValidateRawSector(CDIF *cdif, uint8 *buf)
+bool CDIF_ValidateRawSector(CDIF *cdif, uint8 *buf, uint32 lba)
 {
    int mode = buf[12 + 3];
 
@@ -91,7 +381,44 @@ bool CDIF_ValidateRawSector(CDIF *cdif, uint8 *buf)
       return(false);
 
 #ifdef WANT_ECC
-   if(!edc_lec_check_and_correct(buf, mode == 2))
+   CDIF_RepairedSector *rs = &cdif->repaired[lba & (CDIF_REPAIR_CACHE_SIZE - 1)];
+   const bool tracked = lba < cdif->ecc_status_count;
+   const unsigned bit_shift = (lba & 3) * 2;
+   unsigned status = tracked ? ((cdif->ecc_status[lba >> 2] >> bit_shift) & 3) : CDIF_ECC_UNCHECKED;
+
+   switch(status)
+   {
+      case CDIF_ECC_GOOD:
+         return(true);
+
+      case CDIF_ECC_BAD:
+         return(false);
+
+      case CDIF_ECC_REPAIRED:
+         if(rs->valid && rs->lba == lba)
+         {
+            memcpy(buf, rs->data, 2352);
+            return(true);
+         }
+         break;
+   }
+
+   if(edc_check(buf, mode == 2))
+      status = CDIF_ECC_GOOD;
+   else if(edc_lec_check_and_correct(buf, mode == 2))
+   {
+      status = CDIF_ECC_REPAIRED;
+      memcpy(rs->data, buf, 2352);
+      rs->lba = lba;
+      rs->valid = true;
+   }
+   else
+      status = CDIF_ECC_BAD;
+
+   if(tracked)
+      cdif->ecc_status[lba >> 2] = (cdif->ecc_status[lba >> 2] & ~(3 << bit_shift)) | (status << bit_shift);
+
+   if(status == CDIF_ECC_BAD)
       return(false);
 #endif
 
@@ -115,7 +442,7 @@ int CDIF_ReadSector(CDIF *cdif, uint8* pBuf, uint32 lba, uint32 nSectors)
          return(FALSE);
       }
 
-      if(!CDIF_ValidateRawSector(cdif, tmpbuf))
+      if(!CDIF_ValidateRawSector(cdif, tmpbuf, lba))
       {
          if (log_cb)
          {
@@ -159,6 +486,14 @@ bool CDIF_ReadRawSector(CDIF *cdif, uint8 *buf, uint32 lba)
       return(false);
    }
 
+#ifdef WANT_THREADING
+   if(cdif->ra)
+   {
+      CDIF_RA_ReadRawSector(cdif, buf, lba);
+      return(true);
+   }
+#endif
+
    cdif->disc_cdaccess->Read_Raw_Sector(buf, lba);
 
    return(true);
@@ -174,6 +509,22 @@ bool CDIF_Eject(CDIF *cdif, bool eject_status)
 
    if(old_de != cdif->DiscEjected)
    {
+      bool ret = true;
+
+#ifdef WANT_THREADING
+      CDIF_ReadAhead *ra = cdif->ra;
+
+      if(ra)
+      {
+         MDFND_LockMutex(ra->mutex);
+
+         while(ra->busy)
+            MDFND_WaitCond(ra->done_cond, ra->mutex);
+
+         CDIF_RA_Invalidate(ra);
+      }
+#endif
+
       cdif->disc_cdaccess->Eject(eject_status);
 
       if(!eject_status)     // Re-read the TOC
@@ -183,9 +534,16 @@ bool CDIF_Eject(CDIF *cdif, bool eject_status)
          if(cdif->disc_toc.first_track < 1 || cdif->disc_toc.last_track > 99 || cdif->disc_toc.first_track > cdif->disc_toc.last_track)
          {
             log_cb(RETRO_LOG_ERROR, "TOC first(%d)/last(%d) track numbers bad.\n", cdif->disc_toc.first_track, cdif->disc_toc.last_track);
-            return false;
+            ret = false;
          }
       }
+
+#ifdef WANT_THREADING
+      if(ra)
+         MDFND_UnlockMutex(ra->mutex);
+#endif
+
+      return ret;
    }
 
    return true;
@@ -309,7 +667,21 @@ void *CDIF_MakeStream(CDIF *cdif, uint32 lba, uint32 sector_count)
 }
 
 
-CDIF *CDIF_Open(const char *path, const bool is_device, bool image_memcache)
+CDIF *CDIF_Open(const char *path, const bool is_device, bool image_memcache, unsigned disc)
+{
+   CDIF *cdif = CDIF_New(cdaccess_open_image(path, image_memcache, disc));
+
+#ifdef WANT_THREADING
+   // Nothing to hide when the whole image is already in memory.  That's decided by what was actually built, since
+   // cdaccess_open_image() falls back to reading from disk if the image can't be loaded into RAM.
+   if(cdif && !dynamic_cast<CDAccess_Memory *>(cdif->disc_cdaccess))
+      CDIF_RA_Start(cdif);
+#endif
+
+   return cdif;
+}
+
+unsigned CDIF_GetDiscCount(const char *path)
 {
-   return CDIF_New(cdaccess_open_image(path, image_memcache)); 
+   return cdaccess_get_disc_count(path);
 }
@@ -26,12 +26,34 @@
 
 typedef CDUtility::TOC CD_TOC;
 
+struct CDIF_ReadAhead;
+struct CDIF_RepairedSector;
+
+// Identity of the disc behind a CDIF, worked out once per disc by the system emulation code(the PSX code fills it in
+// from SYSTEM.CNF or the license sector, see PSX_CalcDiscSCEx()) so it doesn't have to keep reading the disc.
+struct CDIF_DiscIdentity
+{
+   bool valid;
+   const char *scex_id;		// "SCEA", "SCEE" or "SCEI"; NULL if not determined.
+   bool license_unknown;	// There's a license string, but it doesn't name a region.
+   int region;			// Region the disc declares(system-specific value), or -1.
+   char game_id[16];		// Boot executable name from SYSTEM.CNF(e.g. "SLUS_005.94"), or "".
+
+   bool md5_valid;
+   uint8 layout_md5[16];	// MD5 of the TOC layout.
+};
+
 typedef struct CDInterface
 {
    bool UnrecoverableError;
    CDUtility::TOC disc_toc;
    bool DiscEjected;
    CDAccess *disc_cdaccess;
+   CDIF_ReadAhead *ra;	// Read-ahead thread state; NULL when reads are done synchronously.
+   uint8 *ecc_status;	// 2 bits per LBA(see CDIF_ValidateRawSector()), for LBAs 0 through the leadout; NULL without WANT_ECC.
+   uint32 ecc_status_count;
+   CDIF_RepairedSector *repaired;
+   CDIF_DiscIdentity identity;	// Zeroed(not valid) by CDIF_New().
 } CDIF;
 
 CDIF *CDIF_New(CDAccess *cda);
@@ -45,8 +67,9 @@ static inline void CDIF_ReadTOC(CDIF *cdif, CDUtility::TOC *read_target)
 
 bool CDIF_ReadRawSector(CDIF *cdif, uint8 *buf, uint32 lba);
 
-// Call for mode 1 or mode 2 form 1 only.
-bool CDIF_ValidateRawSector(CDIF *cdif, uint8 *buf);
+// Call for mode 1 or mode 2 form 1 only.  The outcome is remembered per LBA, so a sector's EDC/L-EC is only
+// computed the first time it's validated; buf must hold the sector as read from lba.
+bool CDIF_ValidateRawSector(CDIF *cdif, uint8 *buf, uint32 lba);
 
 // Utility/Wrapped functions
 // Reads mode 1 and mode2 form 1 sectors(2048 bytes per sector returned)
@@ -61,6 +84,10 @@ bool CDIF_Eject(CDIF *cdif, bool eject_status);
 // No reference counting or whatever is done, so if you destroy the CDIF object before you destroy the returned Stream, things will go BOOM.
 void *CDIF_MakeStream(CDIF *cdif, uint32 lba, uint32 sector_count);
 
-CDIF *CDIF_Open(const char *path, const bool is_device, bool image_memcache);
+// "disc" selects the disc in image formats that can hold more than one(PBP); see CDIF_GetDiscCount().
+CDIF *CDIF_Open(const char *path, const bool is_device, bool image_memcache, unsigned disc = 0);
+
+// Returns the number of discs in the image at "path"; 1 for formats that only hold one.
+unsigned CDIF_GetDiscCount(const char *path);
 
 #endif
@@ -17,20 +17,31 @@ void MDFND_Sleep(uint32 ms);
 // Mostly based off SDL's prototypes and semantics.
 // Driver code should actually define MDFN_Thread and MDFN_Mutex.
 
+// The libretro port implements these in threads.c.
+
 struct MDFN_Thread;
 struct MDFN_Mutex;
 struct MDFN_Cond;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 MDFN_Thread *MDFND_CreateThread(int (*fn)(void *), void *data);
 void MDFND_WaitThread(MDFN_Thread *thread, int *status);
 void MDFND_KillThread(MDFN_Thread *thread);
 
 MDFN_Mutex *MDFND_CreateMutex(void);
+void MDFND_DestroyMutex(MDFN_Mutex *mutex);
+int MDFND_LockMutex(MDFN_Mutex *mutex);
+int MDFND_UnlockMutex(MDFN_Mutex *mutex);
+
 MDFN_Cond *MDFND_CreateCond(void);
 void MDFND_DestroyCond(MDFN_Cond *cond);
-void MDFND_DestroyMutex(MDFN_Mutex *mutex);
 int MDFND_WaitCond(MDFN_Cond *cond, MDFN_Mutex *mutex);
 int MDFND_SignalCond(MDFN_Cond *cond);
+#ifdef __cplusplus
+}
+#endif
 
 /* End threading support. */
 #endif
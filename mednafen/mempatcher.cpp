@@ -26,6 +26,7 @@
 #include "general.h"
 #include "md5.h"
 #include "mempatcher.h"
+#include "psx/dirty.h"
 
 #ifdef _WIN32
 #include "msvc_compat.h"
@@ -662,6 +663,7 @@ void MDFNMP_ApplyPeriodicCheats(void)
        tmpval >>= x * 8;
 
       RAMPtrs[page][(chit->addr + x) % PageSize] = tmpval;
+      PSX_DirtyMark(PSX_DIRTY_MAINRAM, chit->addr + x);	// Only MainRAM is registered, at 0.
      }
    }
   }
@@ -0,0 +1,381 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "mednafen.h"
+#include "movie.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "../libretro.h"
+
+extern retro_log_printf_t log_cb;
+
+#define MOVIE_VERSION		1
+#define MOVIE_HEADER_SIZE	80
+#define MOVIE_FRAMES_OFFSET	68
+
+enum
+{
+ MDFNMOV_REC_END = 0,
+ MDFNMOV_REC_FRAME,
+ MDFNMOV_REC_IDLE,
+ MDFNMOV_REC_EVENT
+};
+
+static unsigned Movie_Mode = MDFNMOV_IDLE;
+static MDFNMOV_Info Movie_Info;
+static uint64 Movie_FrameNum;
+
+// Input of the previous frame; frames only carry the ports that changed from it.
+static std::vector<uint8> Movie_PrevInput;
+
+// Recording
+static FILE *Movie_File = NULL;
+static uint32 Movie_IdleRun;
+
+// Playback
+static std::vector<uint8> Movie_Data;
+static uint32 Movie_Pos;
+static uint32 Movie_StateSize;
+static uint32 Movie_IdleLeft;
+
+static void Movie_Put32(uint8 *p, uint32 v)
+{
+ p[0] = v >> 0;
+ p[1] = v >> 8;
+ p[2] = v >> 16;
+ p[3] = v >> 24;
+}
+
+static uint32 Movie_Get32(const uint8 *p)
+{
+ return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+static void Movie_PutVarint(uint32 v)
+{
+ while(v >= 0x80)
+ {
+  fputc((v & 0x7F) | 0x80, Movie_File);
+  v >>= 7;
+ }
+ fputc(v, Movie_File);
+}
+
+static bool Movie_GetVarint(uint32 *v)
+{
+ *v = 0;
+
+ for(unsigned shift = 0; shift < 32; shift += 7)
+ {
+  uint8 b;
+
+  if(Movie_Pos >= Movie_Data.size())
+   return false;
+
+  b = Movie_Data[Movie_Pos++];
+  *v |= (uint32)(b & 0x7F) << shift;
+
+  if(!(b & 0x80))
+   return true;
+ }
+
+ return false;
+}
+
+static void Movie_FlushIdle(void)
+{
+ if(!Movie_IdleRun)
+  return;
+
+ fputc(MDFNMOV_REC_IDLE, Movie_File);
+ Movie_PutVarint(Movie_IdleRun);
+ Movie_IdleRun = 0;
+}
+
+bool MDFNMOV_StartRecord(const char *path, const MDFNMOV_Info *info, const uint8 *state, uint32 state_size)
+{
+ uint8 header[MOVIE_HEADER_SIZE];
+ unsigned i;
+
+ MDFNMOV_Stop();
+
+ if(info->ports > MDFNMOV_MAX_PORTS)
+  return false;
+
+ if(!(Movie_File = fopen(path, "wb")))
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_ERROR, "Error opening movie \"%s\" for writing.\n", path);
+  return false;
+ }
+
+ memset(header, 0, sizeof(header));
+ memcpy(header, "PSXMOVIE", 8);
+ Movie_Put32(header + 8, MOVIE_VERSION);
+ Movie_Put32(header + 12, info->ports);
+ Movie_Put32(header + 16, info->port_size);
+ for(i = 0; i < MDFNMOV_MAX_PORTS; i++)
+  Movie_Put32(header + 20 + i * 4, info->port_device[i]);
+ memcpy(header + 52, info->md5, 16);
+ Movie_Put32(header + 76, state_size);
+
+ if(fwrite(header, 1, sizeof(header), Movie_File) != sizeof(header) || (state_size && fwrite(state, 1, state_size, Movie_File) != state_size))
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_ERROR, "Error writing movie \"%s\".\n", path);
+  fclose(Movie_File);
+  Movie_File = NULL;
+  return false;
+ }
+
+ Movie_Info = *info;
+ Movie_Info.frames = 0;
+ Movie_PrevInput.assign(info->ports * info->port_size, 0);
+ Movie_IdleRun = 0;
+ Movie_FrameNum = 0;
+ Movie_Mode = MDFNMOV_RECORDING;
+
+ return true;
+}
+
+void MDFNMOV_RecordFrame(const uint8 *input)
+{
+ const uint32 port_size = Movie_Info.port_size;
+ uint8 changed = 0;
+ unsigned i;
+
+ if(Movie_Mode != MDFNMOV_RECORDING)
+  return;
+
+ for(i = 0; i < Movie_Info.ports; i++)
+ {
+  if(memcmp(&Movie_PrevInput[i * port_size], input + i * port_size, port_size))
+   changed |= 1 << i;
+ }
+
+ Movie_FrameNum++;
+
+ if(!changed)
+ {
+  Movie_IdleRun++;
+  return;
+ }
+
+ Movie_FlushIdle();
+ fputc(MDFNMOV_REC_FRAME, Movie_File);
+ fputc(changed, Movie_File);
+
+ for(i = 0; i < Movie_Info.ports; i++)
+ {
+  if(changed & (1 << i))
+  {
+   memcpy(&Movie_PrevInput[i * port_size], input + i * port_size, port_size);
+   fwrite(input + i * port_size, 1, port_size, Movie_File);
+  }
+ }
+}
+
+void MDFNMOV_RecordEvent(unsigned event, uint32 param)
+{
+ if(Movie_Mode != MDFNMOV_RECORDING)
+  return;
+
+ Movie_FlushIdle();
+ fputc(MDFNMOV_REC_EVENT, Movie_File);
+ fputc(event, Movie_File);
+ Movie_PutVarint(param);
+}
+
+bool MDFNMOV_StartPlay(const char *path, MDFNMOV_Info *info, const uint8 **state, uint32 *state_size)
+{
+ FILE *fp;
+ long size;
+ const uint8 *header;
+ unsigned i;
+
+ MDFNMOV_Stop();
+
+ if(!(fp = fopen(path, "rb")))
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_ERROR, "Error opening movie \"%s\".\n", path);
+  return false;
+ }
+
+ fseek(fp, 0, SEEK_END);
+ size = ftell(fp);
+ fseek(fp, 0, SEEK_SET);
+
+ if(size >= MOVIE_HEADER_SIZE)
+ {
+  Movie_Data.resize(size);
+  if(fread(&Movie_Data[0], 1, size, fp) != (size_t)size)
+   size = 0;
+ }
+ fclose(fp);
+
+ header = Movie_Data.empty() ? NULL : &Movie_Data[0];
+
+ if(size < MOVIE_HEADER_SIZE || memcmp(header, "PSXMOVIE", 8) || Movie_Get32(header + 8) != MOVIE_VERSION ||
+    Movie_Get32(header + 12) > MDFNMOV_MAX_PORTS || Movie_Get32(header + 76) > (uint32)size - MOVIE_HEADER_SIZE)
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_ERROR, "\"%s\" is not a valid movie.\n", path);
+  std::vector<uint8>().swap(Movie_Data);
+  return false;
+ }
+
+ Movie_Info.ports = Movie_Get32(header + 12);
+ Movie_Info.port_size = Movie_Get32(header + 16);
+ for(i = 0; i < MDFNMOV_MAX_PORTS; i++)
+  Movie_Info.port_device[i] = Movie_Get32(header + 20 + i * 4);
+ memcpy(Movie_Info.md5, header + 52, 16);
+ Movie_Info.frames = Movie_Get32(header + MOVIE_FRAMES_OFFSET) | ((uint64)Movie_Get32(header + MOVIE_FRAMES_OFFSET + 4) << 32);
+ Movie_StateSize = Movie_Get32(header + 76);
+
+ *info = Movie_Info;
+ *state = Movie_StateSize ? header + MOVIE_HEADER_SIZE : NULL;
+ *state_size = Movie_StateSize;
+
+ Movie_PrevInput.assign(Movie_Info.ports * Movie_Info.port_size, 0);
+ Movie_Pos = MOVIE_HEADER_SIZE + Movie_StateSize;
+ Movie_IdleLeft = 0;
+ Movie_FrameNum = 0;
+ Movie_Mode = MDFNMOV_PLAYING;
+
+ return true;
+}
+
+bool MDFNMOV_PlayFrame(uint8 *input, void (*event_cb)(unsigned event, uint32 param))
+{
+ const uint32 port_size = Movie_Info.port_size;
+
+ if(Movie_Mode != MDFNMOV_PLAYING)
+  return false;
+
+ while(!Movie_IdleLeft)
+ {
+  uint8 tag;
+  uint32 param;
+
+  if(Movie_Pos >= Movie_Data.size())
+   goto End;
+
+  tag = Movie_Data[Movie_Pos++];
+
+  if(tag == MDFNMOV_REC_FRAME)
+  {
+   uint8 changed;
+
+   if(Movie_Pos >= Movie_Data.size())
+    goto End;
+
+   changed = Movie_Data[Movie_Pos++];
+
+   for(unsigned i = 0; i < Movie_Info.ports; i++)
+   {
+    if(!(changed & (1 << i)))
+     continue;
+
+    if(Movie_Data.size() - Movie_Pos < port_size)
+     goto End;
+
+    memcpy(&Movie_PrevInput[i * port_size], &Movie_Data[Movie_Pos], port_size);
+    Movie_Pos += port_size;
+   }
+   Movie_IdleLeft = 1;
+  }
+  else if(tag == MDFNMOV_REC_IDLE)
+  {
+   if(!Movie_GetVarint(&param))
+    goto End;
+   Movie_IdleLeft = param;
+  }
+  else if(tag == MDFNMOV_REC_EVENT)
+  {
+   uint8 event;
+
+   if(Movie_Pos >= Movie_Data.size())
+    goto End;
+
+   event = Movie_Data[Movie_Pos++];
+
+   if(!Movie_GetVarint(&param))
+    goto End;
+
+   if(event_cb)
+    event_cb(event, param);
+  }
+  else
+   goto End;
+ }
+
+ Movie_IdleLeft--;
+ Movie_FrameNum++;
+ memcpy(input, &Movie_PrevInput[0], Movie_PrevInput.size());
+
+ return true;
+
+End:
+ if(log_cb)
+  log_cb(RETRO_LOG_INFO, "Movie finished after %llu frames.\n", (unsigned long long)Movie_FrameNum);
+ MDFNMOV_Stop();
+ return false;
+}
+
+void MDFNMOV_Stop(void)
+{
+ if(Movie_Mode == MDFNMOV_RECORDING)
+ {
+  uint8 frames[8];
+  bool ok;
+
+  Movie_FlushIdle();
+  fputc(MDFNMOV_REC_END, Movie_File);
+
+  Movie_Put32(frames + 0, (uint32)Movie_FrameNum);
+  Movie_Put32(frames + 4, (uint32)(Movie_FrameNum >> 32));
+  ok = fseek(Movie_File, MOVIE_FRAMES_OFFSET, SEEK_SET) == 0 && fwrite(frames, 1, 8, Movie_File) == 8;
+  ok &= fclose(Movie_File) == 0;
+  Movie_File = NULL;
+
+  if(!ok && log_cb)
+   log_cb(RETRO_LOG_ERROR, "Error finishing movie.\n");
+ }
+
+ std::vector<uint8>().swap(Movie_Data);
+ Movie_Mode = MDFNMOV_IDLE;
+}
+
+unsigned MDFNMOV_GetMode(void)
+{
+ return Movie_Mode;
+}
+
+uint64 MDFNMOV_GetFrame(void)
+{
+ return Movie_FrameNum;
+}
+
+uint64 MDFNMOV_GetLength(void)
+{
+ return Movie_Mode == MDFNMOV_PLAYING ? Movie_Info.frames : 0;
+}
@@ -0,0 +1,82 @@
+#ifndef __MDFN_MOVIE_H
+#define __MDFN_MOVIE_H
+
+#include "mednafen-types.h"
+
+// Input movies: a per-frame log of every port's input state plus disc and reset events,
+// anchored either to power-on or to a savestate embedded in the file.  Replaying one on the
+// same build reproduces the original run exactly, which is what regression tests and
+// benchmarks on identical workloads need.
+//
+// File layout(all little-endian):
+//
+//  0  "PSXMOVIE"
+//  8  uint32 version
+// 12  uint32 ports, uint32 port_size, uint32 port_device[8]
+// 52  uint8 md5[16]          Game the movie was recorded on.
+// 68  uint64 frames          Filled in when recording stops; 0 if it never did.
+// 76  uint32 state_size      0 for a power-on anchor...
+// 80  state_size bytes       ...else the savestate to start from.
+//
+// followed by records:
+//
+//  MDFNMOV_REC_FRAME  uint8 changed_ports_mask, port_size bytes per changed port
+//  MDFNMOV_REC_IDLE   varint n; n frames with the same input as the one before
+//  MDFNMOV_REC_EVENT  uint8 event, varint param; applies before the next frame
+//  MDFNMOV_REC_END
+//
+// Memory card contents aren't recorded; a power-on anchored movie only replays faithfully
+// with the same cards the recording started with.
+
+enum
+{
+ MDFNMOV_IDLE = 0,
+ MDFNMOV_RECORDING,
+ MDFNMOV_PLAYING
+};
+
+enum
+{
+ MDFNMOV_EVENT_RESET = 0,	// param unused
+ MDFNMOV_EVENT_EJECT,		// param: 1 = tray opened, 0 = closed
+ MDFNMOV_EVENT_SELECT_DISC	// param: disc index
+};
+
+#define MDFNMOV_MAX_PORTS 8
+
+typedef struct
+{
+ uint32 ports;
+ uint32 port_size;
+ uint32 port_device[MDFNMOV_MAX_PORTS];
+ uint8 md5[16];
+ uint64 frames;
+} MDFNMOV_Info;
+
+// Starts writing a movie to path; state/state_size is the anchor savestate, or NULL/0 for
+// power-on(the caller resets the emulated console).  Stops any movie already active.
+bool MDFNMOV_StartRecord(const char *path, const MDFNMOV_Info *info, const uint8 *state, uint32 state_size);
+
+// Once per emulated frame while recording, with info->ports * info->port_size bytes.
+void MDFNMOV_RecordFrame(const uint8 *input);
+void MDFNMOV_RecordEvent(unsigned event, uint32 param);
+
+// Loads a whole movie from path for playback; *state/*state_size point at the anchor
+// savestate(NULL/0 for power-on) and stay valid until playback stops.
+bool MDFNMOV_StartPlay(const char *path, MDFNMOV_Info *info, const uint8 **state, uint32 *state_size);
+
+// Once per emulated frame while playing: fills input like MDFNMOV_RecordFrame() takes it,
+// calling event_cb for the events recorded before the frame.  Returns false, and stops
+// playback, when the movie is over.
+bool MDFNMOV_PlayFrame(uint8 *input, void (*event_cb)(unsigned event, uint32 param));
+
+// Finishes a recording(writing out the frame count) or ends playback.
+void MDFNMOV_Stop(void);
+
+unsigned MDFNMOV_GetMode(void);
+
+// Frames recorded or played so far, and for playback, the movie's length(0 if unknown).
+uint64 MDFNMOV_GetFrame(void);
+uint64 MDFNMOV_GetLength(void);
+
+#endif
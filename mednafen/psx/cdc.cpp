@@ -45,6 +45,10 @@
 #include "cdc.h"
 #include "spu.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 static SimpleFIFOU8 *DMABuffer;
 
 static CDIF *Cur_CDIF;
@@ -625,7 +629,8 @@ static bool CDC_DecodeSubQ(uint8 *subpw)
    return(false);
 }
 
-static const int16 CDADPCMImpulse[7][25] =
+// Padded out to 32 taps(with zeroes) so the FIR can be done 8 taps at a time.
+static const int16 CDADPCMImpulse[7][32] MDFN_ALIGN(16) =
 {
  {     0,    -5,    17,   -35,    70,   -23,   -68,   347,  -839,  2062, -4681, 15367, 21472, -5882,  2810, -1352,   635,  -235,    26,    43,   -35,    16,    -8,     2,     0,  }, /* 0 */
  {     0,    -2,    10,   -34,    65,   -84,    52,     9,  -266,  1024, -2680,  9036, 26516, -6016,  3021, -1571,   848,  -365,   107,    10,   -16,    17,    -8,     3,    -1,  }, /* 1 */
@@ -641,87 +646,107 @@ static const int16 CDADPCMImpulse[7][25] =
  samples[1] = AudioBuffer.Samples[1][AudioBuffer.ReadPos]; \
  AudioBuffer.ReadPos++
 
-/* Algorithmically, volume is applied after resampling for CD-XA ADPCM playback, 
- * per PS1 tests(though when "mute" is applied wasn't tested). */ 
-
-static INLINE void CDC_ApplyVolume(int32 samples[2])
+// 25-tap FIR over wf[0...24](taps 25...31 of imp are zero).
+static INLINE int32 CDC_ResampFIR(const int16 *imp, const int16 *wf)
 {
-   /* Take care not to alter samples[] before we're done calculating the new output samples! */ 
-   int32 left_out = ((samples[0] * DecodeVolume[0][0]) >> 7) + ((samples[1] * DecodeVolume[1][0]) >> 7);
-   int32 right_out = ((samples[0] * DecodeVolume[0][1]) >> 7) + ((samples[1] * DecodeVolume[1][1]) >> 7);
+#if defined(__SSE2__)
+   __m128i acc = _mm_madd_epi16(_mm_load_si128((const __m128i *)&imp[0]), _mm_loadu_si128((const __m128i *)&wf[0]));
 
-   clamp(&left_out, -32768, 32767);
-   clamp(&right_out, -32768, 32767);
+   acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_load_si128((const __m128i *)&imp[8]), _mm_loadu_si128((const __m128i *)&wf[8])));
+   acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_load_si128((const __m128i *)&imp[16]), _mm_loadu_si128((const __m128i *)&wf[16])));
+   acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_load_si128((const __m128i *)&imp[24]), _mm_loadu_si128((const __m128i *)&wf[24])));
+   acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+   acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
 
-   if(Muted)
-   {
-      left_out = 0;
-      right_out = 0;
-   }
+   return _mm_cvtsi128_si32(acc);
+#else
+   int32 ret = 0;
+
+   for(unsigned s = 0; s < 25; s++)
+      ret += imp[s] * wf[s];
 
-   samples[0] = left_out;
-   samples[1] = right_out;
+   return ret;
+#endif
 }
 
 //
-// This function must always set samples[0] and samples[1], even if just to 0; range of samples[n] shall be restricted to -32768 through 32767.
+// Fills samples[0...count-1]; each must always be set, even if just to 0, and the range of each value shall be restricted to
+// -32768 through 32767.
 //
-void CDC_GetCDAudio(int32 samples[2])
+// Volume is applied after resampling for CD-XA ADPCM playback, per PS1 tests(though when "mute" is applied wasn't tested).
+//
+void CDC_GetCDAudioBlock(int32 (*samples)[2], unsigned count)
 {
-   const unsigned freq = (AudioBuffer.ReadPos < AudioBuffer.Size) ? AudioBuffer.Freq : 0;
-
-   samples[0] = 0;
-   samples[1] = 0;
+   // Registers can't change in the middle of a block(the SPU renders it without returning to the CDC), so the volume
+   // matrix is loaded once.
+   const int32 vol_ll = Muted ? 0 : DecodeVolume[0][0];
+   const int32 vol_rl = Muted ? 0 : DecodeVolume[1][0];
+   const int32 vol_lr = Muted ? 0 : DecodeVolume[0][1];
+   const int32 vol_rr = Muted ? 0 : DecodeVolume[1][1];
 
-   if(!freq)
-      return;
-
-   if(freq == 7 || freq == 14)
+   for(unsigned n = 0; n < count; n++)
    {
-      CDC_ReadAudioBuffer(samples);
-      if(freq == 14)
+      const unsigned freq = (AudioBuffer.ReadPos < AudioBuffer.Size) ? AudioBuffer.Freq : 0;
+      int32 raw[2];
+      int32 left_out, right_out;
+
+      if(!freq)
       {
-         CDC_ReadAudioBuffer(samples);
+         // Buffer drained; nothing more will show up until the CDC processes another sector, which can't happen during
+         // this block.
+         for(; n < count; n++)
+         {
+            samples[n][0] = 0;
+            samples[n][1] = 0;
+         }
+         break;
       }
-   }
-   else
-   {
-      int32 out_tmp[2] = { 0, 0 };
 
-      for(unsigned i = 0; i < 2; i++)
+      if(freq == 7 || freq == 14)
+      {
+         CDC_ReadAudioBuffer(raw);
+         if(freq == 14)
+         {
+            CDC_ReadAudioBuffer(raw);
+         }
+      }
+      else
       {
          const int16* imp = CDADPCMImpulse[ADPCM_ResampCurPhase];
-         int16* wf = &ADPCM_ResampBuf[i][(ADPCM_ResampCurPos + 32 - 25) & 0x1F];
 
-         for(unsigned s = 0; s < 25; s++)
+         for(unsigned i = 0; i < 2; i++)
          {
-            out_tmp[i] += imp[s] * wf[s];
+            raw[i] = CDC_ResampFIR(imp, &ADPCM_ResampBuf[i][(ADPCM_ResampCurPos + 32 - 25) & 0x1F]) >> 15;
+            clamp(&raw[i], -32768, 32767);
          }
 
-         out_tmp[i] >>= 15;
-         clamp(&out_tmp[i], -32768, 32767);
-         samples[i] = out_tmp[i];
-      }
+         ADPCM_ResampCurPhase += freq;
 
-      ADPCM_ResampCurPhase += freq;
+         if(ADPCM_ResampCurPhase >= 7)
+         {
+            int32 in[2] = { 0, 0 };
 
-      if(ADPCM_ResampCurPhase >= 7)
-      {
-         int32 raw[2] = { 0, 0 };
+            ADPCM_ResampCurPhase -= 7;
+            CDC_ReadAudioBuffer(in);
 
-         ADPCM_ResampCurPhase -= 7;
-         CDC_ReadAudioBuffer(raw);
-
-         for(unsigned i = 0; i < 2; i++)
-         {
-            ADPCM_ResampBuf[i][ADPCM_ResampCurPos +  0] = 
-               ADPCM_ResampBuf[i][ADPCM_ResampCurPos + 32] = raw[i];
+            for(unsigned i = 0; i < 2; i++)
+            {
+               ADPCM_ResampBuf[i][ADPCM_ResampCurPos +  0] = 
+                  ADPCM_ResampBuf[i][ADPCM_ResampCurPos + 32] = in[i];
+            }
+            ADPCM_ResampCurPos = (ADPCM_ResampCurPos + 1) & 0x1F;
          }
-         ADPCM_ResampCurPos = (ADPCM_ResampCurPos + 1) & 0x1F;
       }
-   }
 
-   CDC_ApplyVolume(samples);
+      left_out = ((raw[0] * vol_ll) >> 7) + ((raw[1] * vol_rl) >> 7);
+      right_out = ((raw[0] * vol_lr) >> 7) + ((raw[1] * vol_rr) >> 7);
+
+      clamp(&left_out, -32768, 32767);
+      clamp(&right_out, -32768, 32767);
+
+      samples[n][0] = left_out;
+      samples[n][1] = right_out;
+   }
 }
 
 
@@ -806,9 +831,58 @@ static bool CDC_XA_Test(const uint8 *sdata)
 }
 
 
+// Expands the 28 samples of each unit of a sound group to (int16)(coded << 12)(4-bit) or (int16)(coded << 8)(8-bit),
+// unit-major.  The sample data is 28 rows of 4 bytes, one byte(or nibble pair) per unit.
+static INLINE void CDC_XA_UnpackSoundGroup(const uint8 *samples, const bool eight_bit, int16 out[8][28])
+{
+#if defined(__SSE2__)
+   const __m128i hm8 = _mm_set1_epi32((int32)0xFF000000);
+   const __m128i hm4 = _mm_set1_epi32((int32)0xF0000000);
+
+   for(unsigned r = 0; r < 28; r += 4)
+   {
+      const __m128i w = _mm_loadu_si128((const __m128i *)&samples[r * 4]);
+
+      for(unsigned b = 0; b < 4; b++)
+      {
+         if(eight_bit)
+         {
+            const __m128i t = _mm_and_si128(_mm_sll_epi32(w, _mm_cvtsi32_si128(24 - 8 * b)), hm8);
+
+            _mm_storel_epi64((__m128i *)&out[b][r], _mm_packs_epi32(_mm_srai_epi32(t, 16), _mm_setzero_si128()));
+         }
+         else
+         {
+            const __m128i lo = _mm_and_si128(_mm_sll_epi32(w, _mm_cvtsi32_si128(28 - 8 * b)), hm4);
+            const __m128i hi = _mm_and_si128(_mm_sll_epi32(w, _mm_cvtsi32_si128(24 - 8 * b)), hm4);
+
+            _mm_storel_epi64((__m128i *)&out[b * 2 + 0][r], _mm_packs_epi32(_mm_srai_epi32(lo, 16), _mm_setzero_si128()));
+            _mm_storel_epi64((__m128i *)&out[b * 2 + 1][r], _mm_packs_epi32(_mm_srai_epi32(hi, 16), _mm_setzero_si128()));
+         }
+      }
+   }
+#else
+   for(unsigned i = 0; i < 28; i++)
+   {
+      for(unsigned b = 0; b < 4; b++)
+      {
+         const uint8 coded = samples[i * 4 + b];
+
+         if(eight_bit)
+            out[b][i] = (int16)(coded << 8);
+         else
+         {
+            out[b * 2 + 0][i] = (int16)((coded & 0x0F) << 12);
+            out[b * 2 + 1][i] = (int16)((coded & 0xF0) << 8);
+         }
+      }
+   }
+#endif
+}
+
 //
 // output should be readable at -2 and -1
-static void DecodeXAADPCM(const uint8 *input, int16 *output, const unsigned shift, const unsigned weight)
+static void DecodeXAADPCM(const int16 *input, int16 *output, const unsigned shift, const unsigned weight)
 {
  // Weights copied over from SPU channel ADPCM playback code, may not be entirely the same for CD-XA ADPCM, we need to run tests.
  static const int32 Weights[16][2] =
@@ -820,18 +894,21 @@ static void DecodeXAADPCM(const uint8 *input, int16 *output, const unsigned shif
   {  98,  -55 },
   { 122,  -60 },
  };
+ const int32 weight_m1 = Weights[weight][0];
+ const int32 weight_m2 = Weights[weight][1];
+ int32 m1 = output[-1];
+ int32 m2 = output[-2];
 
  for(int i = 0; i < 28; i++)
  {
-  int32 sample;
-
-  sample = (int16)(input[i] << 8);
-  sample >>= shift;
+  int32 sample = input[i] >> shift;
 
-  sample += ((output[i - 1] * Weights[weight][0]) >> 6) + ((output[i - 2] * Weights[weight][1]) >> 6);
+  sample += ((m1 * weight_m1) >> 6) + ((m2 * weight_m2) >> 6);
 
   clamp(&sample, -32768, 32767);
   output[i] = sample;
+  m2 = m1;
+  m1 = sample;
  }
 }
 
@@ -839,12 +916,16 @@ static void CDC_XA_ProcessSector(const uint8 *sdata, CD_Audio_Buffer *ab)
 {
    const XA_Subheader *sh = (const XA_Subheader *)&sdata[12 + 4];
    const unsigned unit_index_shift = (sh->coding & XA_CODING_8BIT) ? 0 : 1;
+   const unsigned units = 4U << unit_index_shift;
+   const bool stereo = (bool)(sh->coding & XA_CODING_STEREO);
 
    //printf("File: 0x%02x 0x%02x - Channel: 0x%02x 0x%02x - Submode: 0x%02x 0x%02x - Coding: 0x%02x 0x%02x - \n", sh->file, sh->file_dup, sh->channel, sh->channel_dup, sh->submode, sh->submode_dup, sh->coding, sh->coding_dup);
+   PSX_COUNT(cd_xa_sectors, 1);
+
    ab->ReadPos = 0;
-   ab->Size = 18 * (4 << unit_index_shift) * 28;
+   ab->Size = 18 * units * 28;
 
-   if(sh->coding & XA_CODING_STEREO)
+   if(stereo)
       ab->Size >>= 1;
 
    ab->Freq = (sh->coding & XA_CODING_189) ? 3 : 6;
@@ -854,13 +935,17 @@ static void CDC_XA_ProcessSector(const uint8 *sdata, CD_Audio_Buffer *ab)
    for(unsigned group = 0; group < 18; group++)
    {
       const XA_SoundGroup *sg = (const XA_SoundGroup *)&sdata[12 + 4 + 8 + group * 128];
+      int16 ibuffer[8][28] MDFN_ALIGN(16);
+
+      CDC_XA_UnpackSoundGroup(sg->samples, !unit_index_shift, ibuffer);
 
-      for(unsigned unit = 0; unit < (4U << unit_index_shift); unit++)
+      for(unsigned unit = 0; unit < units; unit++)
       {
          const uint8 param = sg->params[(unit & 3) | ((unit & 4) << 1)];
          const uint8 param_copy = sg->params[4 | (unit & 3) | ((unit & 4) << 1)];
-         uint8 ibuffer[28];
+         const bool ocn = (bool)(unit & 1) && stereo;
          int16 obuffer[2 + 28];
+         int16 *l_out, *r_out;
 
 #if 0
          if(param != param_copy)
@@ -869,25 +954,10 @@ static void CDC_XA_ProcessSector(const uint8 *sdata, CD_Audio_Buffer *ab)
          }
 #endif
 
-         for(unsigned i = 0; i < 28; i++)
-         {
-            uint8 tmp = sg->samples[i * 4 + (unit >> unit_index_shift)];
-
-            if(unit_index_shift)
-            {
-               tmp <<= (unit & 1) ? 0 : 4;
-               tmp &= 0xf0;
-            }
-
-            ibuffer[i] = tmp;
-         }
-
-         const bool ocn = (bool)(unit & 1) && (sh->coding & XA_CODING_STEREO);
-
          obuffer[0] = xa_previous[ocn][0];
          obuffer[1] = xa_previous[ocn][1];
 
-         DecodeXAADPCM(ibuffer, &obuffer[2], param & 0x0F, param >> 4);
+         DecodeXAADPCM(ibuffer[unit], &obuffer[2], param & 0x0F, param >> 4);
 
          xa_previous[ocn][0] = obuffer[28];
          xa_previous[ocn][1] = obuffer[29];
@@ -895,21 +965,21 @@ static void CDC_XA_ProcessSector(const uint8 *sdata, CD_Audio_Buffer *ab)
          if(param != param_copy)
             memset(obuffer, 0, sizeof(obuffer));
 
-         if(sh->coding & XA_CODING_STEREO)
+         if(stereo)
          {
-            for(unsigned s = 0; s < 28; s++)
-            {
-               ab->Samples[ocn][group * (2 << unit_index_shift) * 28 + (unit >> 1) * 28 + s] = obuffer[2 + s];
-            }
+            l_out = &ab->Samples[ocn][group * (units >> 1) * 28 + (unit >> 1) * 28];
+            r_out = NULL;
          }
          else
          {
-            for(unsigned s = 0; s < 28; s++)
-            {
-               ab->Samples[0][group * (4 << unit_index_shift) * 28 + unit * 28 + s] = obuffer[2 + s];
-               ab->Samples[1][group * (4 << unit_index_shift) * 28 + unit * 28 + s] = obuffer[2 + s];
-            }
+            l_out = &ab->Samples[0][group * units * 28 + unit * 28];
+            r_out = &ab->Samples[1][group * units * 28 + unit * 28];
          }
+
+         memcpy(l_out, &obuffer[2], 28 * sizeof(int16));
+
+         if(r_out)
+            memcpy(r_out, &obuffer[2], 28 * sizeof(int16));
       }
    }
 }
@@ -1019,6 +1089,7 @@ static void CDC_HandlePlayRead(void)
    else
 #endif
       CDIF_ReadRawSector(Cur_CDIF, read_buf, CurSector);	// FIXME: error out on error.
+   PSX_COUNT(cd_sectors, 1);
    CDC_DecodeSubQ(read_buf + 2352);
 
 
@@ -1188,6 +1259,8 @@ int32_t CDC_Update(const int32_t timestamp)
 {
    int32 clocks = timestamp - CDC_lastts;
 
+   PSX_PROF_ENTER(PSX_PROF_CDC);
+
    //doom_ts = timestamp;
 
    while(clocks > 0)
@@ -1401,6 +1474,8 @@ int32_t CDC_Update(const int32_t timestamp)
 
    CDC_lastts = timestamp;
 
+   PSX_PROF_LEAVE();
+
    return(timestamp + CDC_CalcNextEvent());
 }
 
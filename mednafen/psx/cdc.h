@@ -85,7 +85,7 @@ bool CDC_DMACanRead(void);
 
 void CDC_SoftReset(void);
 
-void CDC_GetCDAudio(int32 samples[2]);
+void CDC_GetCDAudioBlock(int32 (*samples)[2], unsigned count);
 
 #ifdef __cplusplus
 extern "C" {
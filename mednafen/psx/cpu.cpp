@@ -473,6 +473,8 @@ int32_t PS_CPU::Run(int32_t timestamp_in, const bool ILHMode)
          // Zero must be zero...until the Master Plan is enacted.
          GPR[0] = 0;
 
+         PSX_COUNT(cpu_instructions, 1);
+
 #ifdef HAVE_DEBUG
          if(CPUHook)
          {
@@ -513,6 +515,8 @@ int32_t PS_CPU::Run(int32_t timestamp_in, const bool ILHMode)
                __ICache *ICI = &ICache[((PC & 0xFF0) >> 2)];
                const uint32_t *FMP = (uint32_t *)&FastMap[(PC &~ 0xF) >> FAST_MAP_SHIFT][PC &~ 0xF];
 
+               PSX_COUNT(cpu_icache_misses, 1);
+
                // | 0x2 to simulate (in)validity bits.
                ICI[0x00].TV = (PC &~ 0xF) | 0x00 | 0x2;
                ICI[0x01].TV = (PC &~ 0xF) | 0x04 | 0x2;
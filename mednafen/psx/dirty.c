@@ -0,0 +1,142 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <string.h>
+
+#include "dirty.h"
+
+#define MAINRAM_PAGES ((2048 * 1024) >> PSX_DIRTY_PAGE_SHIFT)
+#define GPURAM_PAGES  ((1024 * 512 * 2) >> PSX_DIRTY_PAGE_SHIFT)
+#define SPURAM_PAGES  ((512 * 1024) >> PSX_DIRTY_PAGE_SHIFT)
+
+static uint8_t MainRAMPages[MAINRAM_PAGES];
+static uint8_t GPURAMPages[GPURAM_PAGES];
+static uint8_t SPURAMPages[SPURAM_PAGES];
+
+// Where marks for untracked regions land; only ever holds 0xFF, so every
+// page of an untracked region tests dirty.
+static uint8_t DirtySink = 0xFF;
+
+static uint8_t * const RegionPages[PSX_DIRTY_REGION_COUNT] = { MainRAMPages, GPURAMPages, SPURAMPages };
+static const uint32_t RegionPageCount[PSX_DIRTY_REGION_COUNT] = { MAINRAM_PAGES, GPURAM_PAGES, SPURAM_PAGES };
+
+// Bit per user tracking the region.
+static uint8_t RegionUsers[PSX_DIRTY_REGION_COUNT];
+
+PSX_DirtyMap PSX_DirtyMaps[PSX_DIRTY_REGION_COUNT] =
+{
+   { &DirtySink, 0 },
+   { &DirtySink, 0 },
+   { &DirtySink, 0 },
+};
+
+static void SetUserBits(unsigned region, uint8_t bits)
+{
+   uint8_t *pages = RegionPages[region];
+   uint32_t i;
+
+   for (i = 0; i < RegionPageCount[region]; i++)
+      pages[i] |= bits;
+}
+
+void PSX_DirtyEnable(unsigned region, unsigned user, bool enable)
+{
+   const uint8_t bit = 1 << user;
+
+   if (enable == PSX_DirtyEnabled(region, user))
+      return;
+
+   if (enable)
+   {
+      // Nothing is known about what happened before now.  Bits of users
+      // that aren't tracking stay set, so they read every page as dirty.
+      if (!RegionUsers[region])
+         memset(RegionPages[region], 0xFF, RegionPageCount[region]);
+      else
+         SetUserBits(region, bit);
+
+      RegionUsers[region] |= bit;
+   }
+   else
+   {
+      SetUserBits(region, bit);
+      RegionUsers[region] &= ~bit;
+   }
+
+   if (RegionUsers[region])
+   {
+      PSX_DirtyMaps[region].map  = RegionPages[region];
+      PSX_DirtyMaps[region].mask = RegionPageCount[region] - 1;
+   }
+   else
+   {
+      PSX_DirtyMaps[region].map  = &DirtySink;
+      PSX_DirtyMaps[region].mask = 0;
+   }
+}
+
+bool PSX_DirtyEnabled(unsigned region, unsigned user)
+{
+   return (RegionUsers[region] >> user) & 1;
+}
+
+uint32_t PSX_DirtyPageCount(unsigned region)
+{
+   return RegionPageCount[region];
+}
+
+uint32_t PSX_DirtyGet(unsigned region, unsigned user, uint8_t *bitmap, bool reset)
+{
+   const uint32_t count = RegionPageCount[region];
+   uint32_t dirty       = 0;
+   uint32_t i;
+
+   memset(bitmap, 0, (count + 7) / 8);
+
+   for (i = 0; i < count; i++)
+   {
+      if (!PSX_DirtyTest(region, user, i))
+         continue;
+
+      bitmap[i >> 3] |= 1 << (i & 7);
+      dirty++;
+   }
+
+   if (reset)
+      PSX_DirtyReset(region, user);
+
+   return dirty;
+}
+
+void PSX_DirtyReset(unsigned region, unsigned user)
+{
+   const uint8_t keep = ~(1 << user);
+   uint8_t *pages     = RegionPages[region];
+   uint32_t i;
+
+   if (!PSX_DirtyEnabled(region, user))
+      return;
+
+   for (i = 0; i < RegionPageCount[region]; i++)
+      pages[i] &= keep;
+}
+
+void PSX_DirtyMarkAll(unsigned region)
+{
+   if (RegionUsers[region])
+      memset(RegionPages[region], 0xFF, RegionPageCount[region]);
+}
@@ -0,0 +1,88 @@
+#ifndef __MDFN_PSX_DIRTY_H
+#define __MDFN_PSX_DIRTY_H
+
+#include <stdint.h>
+#include <boolean.h>
+
+#include "../mednafen-types.h"
+
+//
+// Opt-in dirty page tracking for MainRAM, GPURAM and SPURAM, for incremental
+// savestates, rewind, netplay resync and memory inspection.
+//
+// Every write path marks its page unconditionally.  While a region isn't
+// tracked its map points at a one-byte sink and its mask is 0, so the mark is
+// the same load/and/store either way and there is no branch on the hot path.
+//
+// Each page byte holds one bit per user, so independent consumers(the
+// frontend API, state hashing) can enable, query and reset without stealing
+// each other's marks; a mark sets all bits.  A page is dirty for a user if it
+// may have changed since that user's last PSX_DirtyReset().  Power, state
+// loads, and a user enabling tracking mark the whole region dirty; cheat
+// writes are marked like any other.  Writes that go around the emulated
+// hardware(the frontend poking RETRO_MEMORY_SYSTEM_RAM) aren't seen.
+//
+enum
+{
+   PSX_DIRTY_MAINRAM = 0,
+   PSX_DIRTY_GPURAM,
+   PSX_DIRTY_SPURAM,
+
+   PSX_DIRTY_REGION_COUNT
+};
+
+enum
+{
+   PSX_DIRTY_USER_FRONTEND = 0,  // retro_psx_dirty_*()
+   PSX_DIRTY_USER_STATE_HASH,    // mednafen/state_hash.cpp
+   PSX_DIRTY_USER_RUN_AHEAD,     // RunAhead() in libretro.cpp
+
+   PSX_DIRTY_USER_COUNT          // At most 8.
+};
+
+#define PSX_DIRTY_PAGE_SHIFT  12
+#define PSX_DIRTY_PAGE_SIZE   (1U << PSX_DIRTY_PAGE_SHIFT)
+
+typedef struct
+{
+   uint8_t *map;
+   uint32_t mask;
+} PSX_DirtyMap;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern PSX_DirtyMap PSX_DirtyMaps[PSX_DIRTY_REGION_COUNT];
+
+// offset is in bytes from the start of the region.
+static INLINE void PSX_DirtyMark(unsigned region, uint32_t offset)
+{
+   PSX_DirtyMaps[region].map[(offset >> PSX_DIRTY_PAGE_SHIFT) & PSX_DirtyMaps[region].mask] = 0xFF;
+}
+
+void PSX_DirtyEnable(unsigned region, unsigned user, bool enable);
+bool PSX_DirtyEnabled(unsigned region, unsigned user);
+
+uint32_t PSX_DirtyPageCount(unsigned region);
+
+// Whether one page is dirty for user; always true while user isn't tracking
+// the region.
+static INLINE bool PSX_DirtyTest(unsigned region, unsigned user, uint32_t page)
+{
+   return (PSX_DirtyMaps[region].map[page & PSX_DirtyMaps[region].mask] >> user) & 1;
+}
+
+// Packs the region's dirty pages into bitmap(one bit per page, LSB first;
+// (PSX_DirtyPageCount() + 7) / 8 bytes), optionally resetting them, and
+// returns the number of dirty pages.
+uint32_t PSX_DirtyGet(unsigned region, unsigned user, uint8_t *bitmap, bool reset);
+
+void PSX_DirtyReset(unsigned region, unsigned user);
+void PSX_DirtyMarkAll(unsigned region);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
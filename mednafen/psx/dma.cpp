@@ -442,7 +442,12 @@ static INLINE void RunChannelI(const unsigned ch, const uint32_t CRModeCache, in
          ChRW(ch, CRModeCache, &vtmp, &voffs);
 
          if(!(CRModeCache & 0x1))
-            MainRAM.WriteU32((DMACH[ch].CurAddr + (voffs << 2)) & 0x1FFFFC, vtmp);
+         {
+            const uint32_t wa = (DMACH[ch].CurAddr + (voffs << 2)) & 0x1FFFFC;
+
+            PSX_DirtyMark(PSX_DIRTY_MAINRAM, wa);
+            MainRAM.WriteU32(wa, vtmp);
+         }
       }
 
       if(CRModeCache & 0x2)
@@ -452,6 +457,7 @@ static INLINE void RunChannelI(const unsigned ch, const uint32_t CRModeCache, in
 
       DMACH[ch].WordCounter--;
       DMACH[ch].ClockCounter--;
+      PSX_COUNT(dma_words[ch], 1);
 
 SkipPayloadStuff: ;
 
@@ -2317,6 +2317,8 @@ void InputDevice_Memcard::Format(void)
       card_data[A + 0x08] = 0xFF;
       card_data[A + 0x09] = 0xFF;
    }
+
+ memset(dirty_frames, 0xFF, sizeof(dirty_frames));
 }
 
 InputDevice_Memcard::InputDevice_Memcard()
@@ -2359,6 +2361,9 @@ void InputDevice_Memcard::Power(void)
  presence_new = true;
 }
 
+// card_data before a state load, to find what the load changed.
+static uint8 Memcard_PrevData[1 << 17];
+
 int InputDevice_Memcard::StateAction(StateMem* sm, int load, int data_only, const char* section_name)
 {
  // Don't save dirty_count.
@@ -2400,13 +2405,32 @@ int InputDevice_Memcard::StateAction(StateMem* sm, int load, int data_only, cons
     {
        std::string tmp_name = std::string(section_name) + "_DT";
 
+       // Only count the load as a write if it changed something, so that run-ahead and
+       // rewind, which load states every frame, don't keep postponing the save.
+       if(load)
+          memcpy(Memcard_PrevData, card_data, sizeof(card_data));
+
        ret &= MDFNSS_StateAction(sm, load, CD_StateRegs, tmp_name.c_str());
     }
 
     if(load)
     {
        if(data_used)
-          dirty_count++;
+       {
+          bool changed = false;
+
+          for(unsigned frame = 0; frame < (sizeof(card_data) >> 7); frame++)
+          {
+             if(memcmp(&card_data[frame << 7], &Memcard_PrevData[frame << 7], 128))
+             {
+                dirty_frames[frame >> 3] |= 1 << (frame & 7);
+                changed = true;
+             }
+          }
+
+          if(changed)
+             dirty_count++;
+       }
        else
        {
           //printf("Format: %s\n", section_name);
@@ -2661,6 +2685,7 @@ bool InputDevice_Memcard::Clock(bool TxD, int32 &dsr_pulse_delay)
                {
                   memcpy(&card_data[addr << 7], rw_buffer, 128);
                   dirty_count++;
+                  dirty_frames[addr >> 3] |= 1 << (addr & 7);
                   data_used = true;
                }
             }
@@ -2703,9 +2728,13 @@ static void Memcard_WriteNV(InputDevice_Memcard *device, const uint8 *buffer, ui
 
    while(size--)
    {
+      const uint32 frame = (offset & (sizeof(device->card_data) - 1)) >> 7;
+
       if(device->card_data[offset & (sizeof(device->card_data) - 1)] != *buffer)
          device->data_used = true;
 
+      device->dirty_frames[frame >> 3] |= 1 << (frame & 7);
+
       device->card_data[offset & (sizeof(device->card_data) - 1)] = *buffer;
       buffer++;
       offset++;
@@ -4610,32 +4639,35 @@ void FrontIO_SaveMemcard(unsigned int which)
 
       Memcard_ReadNV(device, device->card_data, 0, 1 << 17);
 
+      memset(device->dirty_frames, 0, sizeof(device->dirty_frames));
       device->dirty_count = 0;		// There's no need to rewrite the file if it's the same data.
    }
 }
 
-void FrontIO_SaveMemcard(unsigned int which, const char *path)
+bool FrontIO_TakeMemcardChanges(unsigned int which, uint8 *image, bool all)
 {
    assert(which < 8);
 
-   if(DevicesMC[which]->GetNVSize() && DevicesMC[which]->GetNVDirtyCount())
-   {
-      FILE *fp = fopen(path, "rb");
-
-      if (!fp)
-         return;
+   if(!DevicesMC[which]->GetNVSize() || (!all && !DevicesMC[which]->GetNVDirtyCount()))
+      return false;
 
-      InputDevice_Memcard *device = (InputDevice_Memcard*)DevicesMC[which];
+   InputDevice_Memcard *device = (InputDevice_Memcard*)DevicesMC[which];
 
-      if (!device)
-         return;
+   if(all)
+      memcpy(image, device->card_data, sizeof(device->card_data));
+   else
+   {
+      for(unsigned frame = 0; frame < (sizeof(device->card_data) >> 7); frame++)
+      {
+         if(device->dirty_frames[frame >> 3] & (1 << (frame & 7)))
+            memcpy(&image[frame << 7], &device->card_data[frame << 7], 128);
+      }
+   }
 
-      Memcard_ReadNV(device, device->card_data, 0, 1 << 17);
+   memset(device->dirty_frames, 0, sizeof(device->dirty_frames));
+   device->dirty_count = 0;
 
-      fwrite(device->card_data, 1, (1 << 17), fp);
-      fclose(fp);
-      device->dirty_count = 0;		// There's no need to rewrite the file if it's the same data.
-   }
+   return true;
 }
 
 #if 0
@@ -4709,6 +4741,22 @@ void FrontIO_GPULineHook(const int32_t timestamp, const int32_t line_timestamp,
    PSX_SetEventNT(PSX_EVENT_FIO, FrontIO_CalcNextEventTS(timestamp, 0x10000000));
 }
 
+bool FrontIO_SamplesPixels(void)
+{
+   unsigned i;
+
+   for(i = 0; i < 8; i++)
+   {
+      switch (DevicesType[i])
+      {
+         case INPUTDEVICE_GUNCON:
+         case INPUTDEVICE_JUSTIFIER:
+            return(true);
+      }
+   }
+
+   return(false);
+}
 
 static InputDeviceInfoStruct InputDeviceInfoPSXPort[] =
 {
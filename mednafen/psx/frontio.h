@@ -95,6 +95,12 @@ class InputDevice_Memcard : public InputDevice
  //
  uint64 dirty_count;
 
+ //
+ // Bit per 128-byte frame of card_data changed since the last FrontIO_TakeMemcardChanges(),
+ // maintained alongside dirty_count.
+ //
+ uint8 dirty_frames[(1 << 17) / 128 / 8];
+
  bool dtr;
  int32 command_phase;
  uint32 bitpos;
@@ -124,6 +130,10 @@ void FrontIO_GPULineHook(const int32_t timestamp,
       const unsigned width, const unsigned pix_clock_offset,
       const unsigned pix_clock, const unsigned pix_clock_divider);
 
+// True if a light gun is plugged in: its GPULineHook() samples the pixels of
+// each line, so the GPU has to draw them even for a frame nobody will see.
+bool FrontIO_SamplesPixels(void);
+
 void FrontIO_UpdateInput(void);
 void FrontIO_SetInput(unsigned int port, const char *type, void *ptr);
 void FrontIO_SetAMCT(bool enabled);
@@ -133,9 +143,13 @@ void *FrontIO_GetMemcardDevice(unsigned int which);
 uint64_t FrontIO_GetMemcardDirtyCount(unsigned int which);
 void FrontIO_LoadMemcard(unsigned int which, const char *path);
 void FrontIO_LoadMemcard(unsigned int which);
-void FrontIO_SaveMemcard(unsigned int which, const char *path); //, bool force_save = false);
 void FrontIO_SaveMemcard(unsigned int which);
 
+// Copies the frames changed since the last call into image(a mirror of the card as last
+// saved), clears the card's dirty state and returns true; returns false without touching
+// image if nothing changed.  With "all", copies the whole card regardless.
+bool FrontIO_TakeMemcardChanges(unsigned int which, uint8 *image, bool all);
+
 int FrontIO_StateAction(StateMem* sm, int load, int data_only);
 
 extern InputInfoStruct FIO_InputInfo;
@@ -174,6 +174,12 @@ enum
  // Y, X
 static uint16 GPURAM[512][1024];
 
+// A GPURAM row is 2KiB, so each dirty page covers two rows(see dirty.h).
+static INLINE void GPU_MarkDirty(int32 y)
+{
+   PSX_DirtyMark(PSX_DIRTY_GPURAM, (uint32)(y & 511) << 11);
+}
+
 static uint32 GPU_DMAControl;
 
  //
@@ -284,6 +290,7 @@ static bool sl_zero_reached;
 
 static EmulateSpecStruct *espec;
 static MDFN_Surface *surface;
+static bool skip_pixels;   // espec->skip, and no light gun needs the pixels.
 static MDFN_Rect *DisplayRect;
 static int32 *LineWidths;
 static bool HardwarePALType;
@@ -341,6 +348,7 @@ uint16 GPU_PeekRAM(uint32 A)
 
 void GPU_PokeRAM(uint32 A, uint16 V)
 {
+   GPU_MarkDirty(A >> 10);
    GPURAM[(A >> 10) & 0x1FF][A & 0x3FF] = V;
 }
 
@@ -552,6 +560,7 @@ static void GPU_SoftReset(void)
 void GPU_Power(void)
 {
    memset(GPURAM, 0, sizeof(GPURAM));
+   PSX_DirtyMarkAll(PSX_DIRTY_GPURAM);
 
    GPU_DMAControl = 0;
 
@@ -703,7 +712,11 @@ static INLINE void GPU_PlotPixel(int BlendMode, bool MaskEval_TA, bool textured,
    }
 
    if(!MaskEval_TA || !(GPURAM[y][x] & 0x8000))
+   {
+      PSX_COUNT(gpu_pixels, 1);
+      GPU_MarkDirty(y);
       GPURAM[y][x] = (textured ? pix : (pix & 0x7FFF)) | MaskSetOR;
+   }
 }
 
 static INLINE uint16_t GPU_GetTexel(uint32_t TexMode_TA, const uint32_t clut_offset, int32 u_arg, int32 v_arg)
@@ -746,7 +759,7 @@ int GPU_StateAction(StateMem *sm, int load, int data_only)
 {
    SFORMAT StateRegs[] =
    {
-      { ((&GPURAM[0][0])), (uint32)(((sizeof(GPURAM) / sizeof(GPURAM[0][0]))) * sizeof(uint16)), 0x20000000 | 0, "&GPURAM[0][0]" },
+      { ((&GPURAM[0][0])), (uint32)(((sizeof(GPURAM) / sizeof(GPURAM[0][0]))) * sizeof(uint16)), 0x20000000 | MDFNSTATE_TRACKED | PSX_DIRTY_GPURAM, "&GPURAM[0][0]" },
 
       { &((GPU_DMAControl)), sizeof((GPU_DMAControl)), 0x80000000 | 0, "DMAControl" },
 
@@ -1658,6 +1671,9 @@ static void G_Command_FBFill(const uint32 *cb)
       if(LineSkipTest(d_y))
          continue;
 
+      GPU_MarkDirty(d_y);
+      PSX_COUNT(gpu_pixels, width);
+
       for(x = 0; x < width; x++)
       {
          const int32 d_x = (x + destX) & 1023;
@@ -1688,6 +1704,9 @@ static void G_Command_FBCopy(const uint32 *cb)
 
    for(int32 y = 0; y < height; y++)
    {
+      GPU_MarkDirty(y + destY);
+      PSX_COUNT(gpu_pixels, width);
+
       for(int32 x = 0; x < width; x += 128)
       {
          const int32 chunk_x_max = std::min<int32>(width - x, 128);
@@ -1952,7 +1971,11 @@ static void GPU_ProcessFIFO(void)
          for(i = 0; i < 2; i++)
          {
             if(!(GPURAM[FBRW_CurY & 511][FBRW_CurX & 1023] & MaskEvalAND))
+            {
+               PSX_COUNT(gpu_pixels, 1);
+               GPU_MarkDirty(FBRW_CurY);
                GPURAM[FBRW_CurY & 511][FBRW_CurX & 1023] = cc | MaskSetOR;
+            }
 
             FBRW_CurX++;
             if(FBRW_CurX == (FBRW_X + FBRW_W))
@@ -2004,6 +2027,8 @@ static void GPU_ProcessFIFO(void)
       SimpleFIFO_ReadUnitIncrement(BlitterFIFO);
    }
 
+   PSX_COUNT(gpu_commands[cc], 1);
+
 
    // A very very ugly kludge to support texture mode specialization. fixme/cleanup/SOMETHING in the future.
 
@@ -2925,6 +2950,8 @@ int32_t GPU_Update(const int32_t sys_timestamp)
    int32 sys_clocks = sys_timestamp - GPU_lastts;
    int32 gpu_clocks;
 
+   PSX_PROF_ENTER(PSX_PROF_GPU);
+
    //printf("GPUISH: %d\n", sys_timestamp - GPU_lastts);
 
    if(!sys_clocks)
@@ -3052,7 +3079,8 @@ int32_t GPU_Update(const int32_t sys_timestamp)
 
                         LineWidths[y] = 384;
 
-                        memset(dest, 0, 384 * sizeof(int32));
+                        if(!skip_pixels)
+                           memset(dest, 0, 384 * sizeof(int32));
                      }
                      char buffer[256];
 
@@ -3075,8 +3103,9 @@ int32_t GPU_Update(const int32_t sys_timestamp)
 
                      for(int i = 0; i < (DisplayRect->y + DisplayRect->h); i++)
                      {
-                        surface->pixels[i * surface->pitch32 + 0] =
-                           surface->pixels[i * surface->pitch32 + 1] = 0;
+                        if(!skip_pixels)
+                           surface->pixels[i * surface->pitch32 + 0] =
+                              surface->pixels[i * surface->pitch32 + 1] = 0;
                         LineWidths[i] = 2;
                      }
                   }
@@ -3151,7 +3180,8 @@ int32_t GPU_Update(const int32_t sys_timestamp)
                int32 dx_start = HorizStart, dx_end = HorizEnd;
 
                dest_line = ((scanline - FirstVisibleLine) << espec->InterlaceOn) + espec->InterlaceField;
-               dest = surface->pixels + dest_line * surface->pitch32;
+               if(!skip_pixels)
+                  dest = surface->pixels + dest_line * surface->pitch32;
 
                if(dx_end < dx_start)
                   dx_end = dx_start;
@@ -3181,6 +3211,7 @@ int32_t GPU_Update(const int32_t sys_timestamp)
 
                LineWidths[dest_line] = dmw;
 
+               if(dest)
                {
                   uint32_t x;
                   const uint16_t *src = GPURAM[DisplayFB_CurLineYReadout];
@@ -3223,6 +3254,8 @@ TheEnd:
 
       //printf("%d\n", next_dt);
 
+      PSX_PROF_LEAVE();
+
       return(sys_timestamp + next_dt);
    }
 }
@@ -3236,6 +3269,10 @@ void GPU_StartFrame(EmulateSpecStruct *espec_arg)
    surface = espec->surface;
    DisplayRect = &espec->DisplayRect;
    LineWidths = espec->LineWidths;
+
+   // A skipped frame still gets its DisplayRect and LineWidths, only the
+   // pixels are left alone.
+   skip_pixels = espec->skip && !FrontIO_SamplesPixels();
 }
 
 bool GPU_DMACanWrite(void)
@@ -57,6 +57,7 @@
 #include "mednafen-types.h"
 #include "../state-common.h"
 #include "mdec.h"
+#include "profile.h"
 
 #include "../cdrom/SimpleFIFO.h"
 #include <math.h>
@@ -65,6 +66,9 @@
 #if defined(__SSE2__)
 #include <xmmintrin.h>
 #include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(MSB_FIRST)
+#define MDEC_NEON
+#include <arm_neon.h>
 #endif
 
 #if defined(ARCH_POWERPC_ALTIVEC) && defined(HAVE_ALTIVEC_H)
@@ -126,6 +130,28 @@ static INLINE uint32 LoadU32_LE(const uint32 *a)
 
 static int32 ClockCounter;
 static unsigned MDRPhase;
+// Input words have been queued by DMA without running the decoder over them
+// yet; see MDEC_DMAWrite() and MDEC_CatchUp().
+static bool RunPending;
+
+static void MDEC_RunI(int32 clocks);
+
+//
+// DMA writes only queue words; the decoder is run over them the next time
+// anything can observe MDEC state.  Nothing else changes while a DMA block is
+// being written(the clock budget and the output FIFO are untouched), so one
+// pass over the whole block leaves the MDEC in exactly the state that running
+// it after every word would have, at a fraction of the cost.
+//
+static INLINE void MDEC_CatchUp(void)
+{
+ if(RunPending)
+ {
+  RunPending = false;
+  MDEC_RunI(0);
+ }
+}
+
 static SimpleFIFOU32 *InFIFO;
 static SimpleFIFOU32 *OutFIFO;
 
@@ -180,6 +206,7 @@ void MDEC_Power(void)
 {
  ClockCounter = 0;
  MDRPhase = 0;
+ RunPending = false;
 
  if (!InFIFO)
  {
@@ -278,7 +305,11 @@ int MDEC_StateAction(void *data, int load, int data_only)
   { 0, 0, 0, 0 }
  };
 
- int ret = MDFNSS_StateAction(data, load, StateRegs, "MDEC");
+ int ret;
+
+ MDEC_CatchUp();
+
+ ret = MDFNSS_StateAction(data, load, StateRegs, "MDEC");
 
  if(load)
  {
@@ -302,75 +333,249 @@ static INLINE int8 Mask9ClampS8(int32 v)
  return v;
 }
 
-static void IDCT_1D_Multi_8(int16 *in_coeff, int8 *out_coeff)
+#if defined(__SSE2__)
+/* Regroups IDCTMatrix so that mt[k][h] holds the coefficient pairs for
+ * u = (2 * k, 2 * k + 1) of outputs x = (4 * h) .. (4 * h + 3); a madd
+ * against a broadcast input pair then yields four partial sums at once. */
+static INLINE void IDCT_PrepMatrix_SSE2(__m128i mt[4][2])
 {
-   unsigned x, col, u;
+   unsigned h;
 
-   (void)u;
+   for(h = 0; h < 2; h++)
+   {
+      __m128i r0 = _mm_load_si128((__m128i *)&IDCTMatrix[(h * 4 + 0) * 8]);
+      __m128i r1 = _mm_load_si128((__m128i *)&IDCTMatrix[(h * 4 + 1) * 8]);
+      __m128i r2 = _mm_load_si128((__m128i *)&IDCTMatrix[(h * 4 + 2) * 8]);
+      __m128i r3 = _mm_load_si128((__m128i *)&IDCTMatrix[(h * 4 + 3) * 8]);
+      __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+      __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+      __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+      __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+      mt[0][h] = _mm_unpacklo_epi64(t0, t1);
+      mt[1][h] = _mm_unpackhi_epi64(t0, t1);
+      mt[2][h] = _mm_unpacklo_epi64(t2, t3);
+      mt[3][h] = _mm_unpackhi_epi64(t2, t3);
+   }
+}
 
-   for(col = 0; col < 8; col++)
+/* All eight outputs of one column, as (sum + 0x4000) >> 15 in two int32 vectors. */
+static INLINE void IDCT_Column_SSE2(__m128i mt[4][2], const int16 *in_coeff, __m128i *lo, __m128i *hi)
+{
+   const __m128i c = _mm_load_si128((__m128i *)in_coeff);
+   __m128i p;
+   __m128i l = _mm_set1_epi32(0x4000);
+   __m128i h = l;
+
+   p = _mm_shuffle_epi32(c, 0x00);
+   l = _mm_add_epi32(l, _mm_madd_epi16(mt[0][0], p));
+   h = _mm_add_epi32(h, _mm_madd_epi16(mt[0][1], p));
+   p = _mm_shuffle_epi32(c, 0x55);
+   l = _mm_add_epi32(l, _mm_madd_epi16(mt[1][0], p));
+   h = _mm_add_epi32(h, _mm_madd_epi16(mt[1][1], p));
+   p = _mm_shuffle_epi32(c, 0xAA);
+   l = _mm_add_epi32(l, _mm_madd_epi16(mt[2][0], p));
+   h = _mm_add_epi32(h, _mm_madd_epi16(mt[2][1], p));
+   p = _mm_shuffle_epi32(c, 0xFF);
+   l = _mm_add_epi32(l, _mm_madd_epi16(mt[3][0], p));
+   h = _mm_add_epi32(h, _mm_madd_epi16(mt[3][1], p));
+
+   *lo = _mm_srai_epi32(l, 15);
+   *hi = _mm_srai_epi32(h, 15);
+}
+#elif defined(MDEC_NEON)
+/* mt[u] holds IDCTMatrix[x * 8 + u] for x = 0..7, i.e. the matrix transposed,
+ * so a column's outputs are the sum over u of mt[u] times input u. */
+static INLINE void IDCT_PrepMatrix_NEON(int16x8_t mt[8])
+{
+   unsigned u, x;
+   int16 t[8] MDFN_ALIGN(16);
+
+   for(u = 0; u < 8; u++)
    {
-#if defined(__SSE2__)
-      __m128i c =  _mm_load_si128((__m128i *)&in_coeff[(col * 8)]);
+      for(x = 0; x < 8; x++)
+         t[x] = IDCTMatrix[(x * 8) + u];
+
+      mt[u] = vld1q_s16(t);
+   }
+}
+
+/* All eight outputs of one column, as (sum + 0x4000) >> 15 in two int32 vectors. */
+static INLINE void IDCT_Column_NEON(const int16x8_t mt[8], const int16 *in_coeff, int32x4_t *lo, int32x4_t *hi)
+{
+   int32x4_t l = vdupq_n_s32(0x4000);
+   int32x4_t h = l;
+   unsigned u;
+
+   for(u = 0; u < 8; u++)
+   {
+      l = vmlal_n_s16(l, vget_low_s16(mt[u]), in_coeff[u]);
+      h = vmlal_n_s16(h, vget_high_s16(mt[u]), in_coeff[u]);
+   }
+
+   *lo = vshrq_n_s32(l, 15);
+   *hi = vshrq_n_s32(h, 15);
+}
 #endif
 
-      for(x = 0; x < 8; x++)
-      {
-         int32 sum = 0;
+static void IDCT_1D_Multi_8(int16 *in_coeff, int8 *out_coeff)
+{
+   unsigned col;
 #if defined(__SSE2__)
-         __m128i sum128;
-         int32 tmp[4] MDFN_ALIGN(16);
+   __m128i mt[4][2];
+
+   IDCT_PrepMatrix_SSE2(mt);
+
+   for(col = 0; col < 8; col++)
+   {
+      __m128i lo, hi, v;
+
+      IDCT_Column_SSE2(mt, &in_coeff[col * 8], &lo, &hi);
+
+      // Mask9ClampS8(): sign-extend from bit 8, then let the saturating packs clamp.
+      lo = _mm_srai_epi32(_mm_slli_epi32(lo, 23), 23);
+      hi = _mm_srai_epi32(_mm_slli_epi32(hi, 23), 23);
+      v = _mm_packs_epi32(lo, hi);
+      v = _mm_packs_epi16(v, v);
+      _mm_storel_epi64((__m128i *)&out_coeff[col * 8], v);
+   }
+#elif defined(MDEC_NEON)
+   int16x8_t mt[8];
 
-         __m128i m = _mm_load_si128((__m128i *)&IDCTMatrix[(x * 8)]);
-         sum128 = _mm_madd_epi16(m, c);
-         sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, (3 << 0) | (2 << 2) | (1 << 4) | (0 << 6)));
-         sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, (1 << 0) | (0 << 2)));
+   IDCT_PrepMatrix_NEON(mt);
 
-         _mm_store_si128((__m128i*)tmp, sum128);
+   for(col = 0; col < 8; col++)
+   {
+      int32x4_t lo, hi;
 
-         sum = tmp[0];
+      IDCT_Column_NEON(mt, &in_coeff[col * 8], &lo, &hi);
+
+      // Mask9ClampS8(): sign-extend from bit 8, then let the saturating narrows clamp.
+      lo = vshrq_n_s32(vshlq_n_s32(lo, 23), 23);
+      hi = vshrq_n_s32(vshlq_n_s32(hi, 23), 23);
+      vst1_s8(&out_coeff[col * 8], vqmovn_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))));
+   }
 #else
+   unsigned x, u;
+
+   for(col = 0; col < 8; col++)
+   {
+      for(x = 0; x < 8; x++)
+      {
+         int32 sum = 0;
+
          for(u = 0; u < 8; u++)
             sum += (in_coeff[(col * 8) + u] * IDCTMatrix[(x * 8) + u]);
-#endif
+
          out_coeff[(col * 8) + x] = Mask9ClampS8((sum + 0x4000) >> 15);
       }
    }
+#endif
 }
 
 static void IDCT_1D_Multi_16(int16 *in_coeff, int16 *out_coeff)
 {
-   unsigned col, x, u;
-   (void)u;
+   unsigned col;
+#if defined(__SSE2__)
+   __m128i mt[4][2];
+   __m128i r[8];
+   __m128i a0, a1, a2, a3, a4, a5, a6, a7;
+   __m128i b0, b1, b2, b3, b4, b5, b6, b7;
+
+   IDCT_PrepMatrix_SSE2(mt);
 
    for(col = 0; col < 8; col++)
    {
-#if defined(__SSE2__)
-      __m128i c =  _mm_load_si128((__m128i *)&in_coeff[(col * 8)]);
-#endif
+      __m128i lo, hi;
 
-      for(x = 0; x < 8; x++)
-      {
-         int32 sum = 0;
-#if defined(__SSE2__)
-         __m128i sum128;
-         int32 tmp[4] MDFN_ALIGN(16);
+      IDCT_Column_SSE2(mt, &in_coeff[col * 8], &lo, &hi);
 
-         __m128i m = _mm_load_si128((__m128i *)&IDCTMatrix[(x * 8)]);
-         sum128 = _mm_madd_epi16(m, c);
-         sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, (3 << 0) | (2 << 2) | (1 << 4) | (0 << 6)));
-         sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, (1 << 0) | (0 << 2)));
+      // Truncate to int16 like the scalar store does, rather than saturating.
+      lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+      hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+      r[col] = _mm_packs_epi32(lo, hi);
+   }
 
-         _mm_store_si128((__m128i*)tmp, sum128);
+   // Output is transposed; r[col] holds x = 0..7 of one column.
+   a0 = _mm_unpacklo_epi16(r[0], r[1]);
+   a1 = _mm_unpackhi_epi16(r[0], r[1]);
+   a2 = _mm_unpacklo_epi16(r[2], r[3]);
+   a3 = _mm_unpackhi_epi16(r[2], r[3]);
+   a4 = _mm_unpacklo_epi16(r[4], r[5]);
+   a5 = _mm_unpackhi_epi16(r[4], r[5]);
+   a6 = _mm_unpacklo_epi16(r[6], r[7]);
+   a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+   b0 = _mm_unpacklo_epi32(a0, a2);
+   b1 = _mm_unpackhi_epi32(a0, a2);
+   b2 = _mm_unpacklo_epi32(a1, a3);
+   b3 = _mm_unpackhi_epi32(a1, a3);
+   b4 = _mm_unpacklo_epi32(a4, a6);
+   b5 = _mm_unpackhi_epi32(a4, a6);
+   b6 = _mm_unpacklo_epi32(a5, a7);
+   b7 = _mm_unpackhi_epi32(a5, a7);
+
+   _mm_store_si128((__m128i *)&out_coeff[0 * 8], _mm_unpacklo_epi64(b0, b4));
+   _mm_store_si128((__m128i *)&out_coeff[1 * 8], _mm_unpackhi_epi64(b0, b4));
+   _mm_store_si128((__m128i *)&out_coeff[2 * 8], _mm_unpacklo_epi64(b1, b5));
+   _mm_store_si128((__m128i *)&out_coeff[3 * 8], _mm_unpackhi_epi64(b1, b5));
+   _mm_store_si128((__m128i *)&out_coeff[4 * 8], _mm_unpacklo_epi64(b2, b6));
+   _mm_store_si128((__m128i *)&out_coeff[5 * 8], _mm_unpackhi_epi64(b2, b6));
+   _mm_store_si128((__m128i *)&out_coeff[6 * 8], _mm_unpacklo_epi64(b3, b7));
+   _mm_store_si128((__m128i *)&out_coeff[7 * 8], _mm_unpackhi_epi64(b3, b7));
+#elif defined(MDEC_NEON)
+   int16x8_t mt[8];
+   int16x8_t r[8];
+   int16x8x2_t a0, a1, a2, a3;
+   int32x4x2_t b0, b1, b2, b3;
+
+   IDCT_PrepMatrix_NEON(mt);
 
-         sum = tmp[0];
+   for(col = 0; col < 8; col++)
+   {
+      int32x4_t lo, hi;
+
+      IDCT_Column_NEON(mt, &in_coeff[col * 8], &lo, &hi);
+
+      // Truncate to int16 like the scalar store does, rather than saturating.
+      r[col] = vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+   }
+
+   // Output is transposed; r[col] holds x = 0..7 of one column.
+   a0 = vtrnq_s16(r[0], r[1]);
+   a1 = vtrnq_s16(r[2], r[3]);
+   a2 = vtrnq_s16(r[4], r[5]);
+   a3 = vtrnq_s16(r[6], r[7]);
+
+   b0 = vtrnq_s32(vreinterpretq_s32_s16(a0.val[0]), vreinterpretq_s32_s16(a1.val[0]));
+   b1 = vtrnq_s32(vreinterpretq_s32_s16(a0.val[1]), vreinterpretq_s32_s16(a1.val[1]));
+   b2 = vtrnq_s32(vreinterpretq_s32_s16(a2.val[0]), vreinterpretq_s32_s16(a3.val[0]));
+   b3 = vtrnq_s32(vreinterpretq_s32_s16(a2.val[1]), vreinterpretq_s32_s16(a3.val[1]));
+
+   vst1q_s16(&out_coeff[0 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b0.val[0]), vget_low_s32(b2.val[0]))));
+   vst1q_s16(&out_coeff[1 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b1.val[0]), vget_low_s32(b3.val[0]))));
+   vst1q_s16(&out_coeff[2 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b0.val[1]), vget_low_s32(b2.val[1]))));
+   vst1q_s16(&out_coeff[3 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b1.val[1]), vget_low_s32(b3.val[1]))));
+   vst1q_s16(&out_coeff[4 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b0.val[0]), vget_high_s32(b2.val[0]))));
+   vst1q_s16(&out_coeff[5 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b1.val[0]), vget_high_s32(b3.val[0]))));
+   vst1q_s16(&out_coeff[6 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b0.val[1]), vget_high_s32(b2.val[1]))));
+   vst1q_s16(&out_coeff[7 * 8], vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b1.val[1]), vget_high_s32(b3.val[1]))));
 #else
+   unsigned x, u;
+
+   for(col = 0; col < 8; col++)
+   {
+      for(x = 0; x < 8; x++)
+      {
+         int32 sum = 0;
+
          for(u = 0; u < 8; u++)
             sum += (in_coeff[(col * 8) + u] * IDCTMatrix[(x * 8) + u]);
-#endif
+
          out_coeff[(x * 8) + col] = (sum + 0x4000) >> 15;
       }
    }
+#endif
 }
 
 /* The formula for green is still a bit off(precision/rounding issues when both cb and cr are non-zero). */
@@ -398,6 +603,138 @@ static INLINE uint16 RGB_to_RGB555(uint8 r, uint8 g, uint8 b)
  return((r << 0) | (g << 5) | (b << 10));
 }
 
+#if defined(__SSE2__)
+/* YCbCr_to_RGB() for one row of eight pixels; cb/cr point at the four chroma
+ * samples covering the row.  Results are 0..255 in int16 lanes, which is the
+ * (uint8)(Mask9ClampS8(...) ^ 0x80) of the scalar macro. */
+static INLINE void YCbCr_to_RGB_Row_SSE2(const int8 *by, const int8 *cb, const int8 *cr, __m128i *r, __m128i *g, __m128i *b)
+{
+   const __m128i round = _mm_set1_epi32(0x80);
+   const __m128i min_s8 = _mm_set1_epi16(-128);
+   const __m128i max_s8 = _mm_set1_epi16(127);
+   const __m128i bias = _mm_set1_epi16(0x80);
+   uint32 cb_raw, cr_raw;
+   __m128i y, cb32, cr32, rt, gt, bt, rg;
+
+   memcpy(&cb_raw, cb, 4);
+   memcpy(&cr_raw, cr, 4);
+
+   // Sign-extend each chroma byte into its own int32 lane; the high halves are
+   // then all-sign, so madd against (k, 0) pairs is a plain 32-bit multiply.
+   cb32 = _mm_cvtsi32_si128(cb_raw);
+   cb32 = _mm_unpacklo_epi8(cb32, cb32);
+   cb32 = _mm_srai_epi32(_mm_unpacklo_epi16(cb32, cb32), 24);
+   cr32 = _mm_cvtsi32_si128(cr_raw);
+   cr32 = _mm_unpacklo_epi8(cr32, cr32);
+   cr32 = _mm_srai_epi32(_mm_unpacklo_epi16(cr32, cr32), 24);
+
+   rt = _mm_madd_epi16(cr32, _mm_set1_epi32(359));
+   rt = _mm_srai_epi32(_mm_add_epi32(rt, round), 8);
+
+   gt = _mm_and_si128(_mm_madd_epi16(cb32, _mm_set1_epi32(-88 & 0xFFFF)), _mm_set1_epi32(~0x1F));
+   gt = _mm_add_epi32(gt, _mm_and_si128(_mm_madd_epi16(cr32, _mm_set1_epi32(-183 & 0xFFFF)), _mm_set1_epi32(~0x07)));
+   gt = _mm_srai_epi32(_mm_add_epi32(gt, round), 8);
+
+   bt = _mm_madd_epi16(cb32, _mm_set1_epi32(454));
+   bt = _mm_srai_epi32(_mm_add_epi32(bt, round), 8);
+
+   // Back to int16, each chroma term repeated for its two pixels.
+   rg = _mm_packs_epi32(rt, gt);
+   rt = _mm_unpacklo_epi16(rg, rg);
+   gt = _mm_unpackhi_epi16(rg, rg);
+   bt = _mm_packs_epi32(bt, bt);
+   bt = _mm_unpacklo_epi16(bt, bt);
+
+   y = _mm_loadl_epi64((const __m128i *)by);
+   y = _mm_srai_epi16(_mm_unpacklo_epi8(y, y), 8);
+
+   rt = _mm_add_epi16(y, rt);
+   gt = _mm_add_epi16(y, gt);
+   bt = _mm_add_epi16(y, bt);
+
+   rt = _mm_srai_epi16(_mm_slli_epi16(rt, 7), 7);
+   gt = _mm_srai_epi16(_mm_slli_epi16(gt, 7), 7);
+   bt = _mm_srai_epi16(_mm_slli_epi16(bt, 7), 7);
+
+   *r = _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(rt, min_s8), max_s8), bias);
+   *g = _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(gt, min_s8), max_s8), bias);
+   *b = _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(bt, min_s8), max_s8), bias);
+}
+
+// RGB_to_RGB555() on eight pixels held as 0..255 int16 lanes.
+static INLINE __m128i RGB_to_RGB555_SSE2(__m128i r, __m128i g, __m128i b)
+{
+   const __m128i four = _mm_set1_epi16(4);
+   const __m128i max5 = _mm_set1_epi16(0x1F);
+
+   r = _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(r, four), 3), max5);
+   g = _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(g, four), 3), max5);
+   b = _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(b, four), 3), max5);
+
+   return _mm_or_si128(r, _mm_or_si128(_mm_slli_epi16(g, 5), _mm_slli_epi16(b, 10)));
+}
+#elif defined(MDEC_NEON)
+// The NEON counterpart of YCbCr_to_RGB_Row_SSE2().
+static INLINE void YCbCr_to_RGB_Row_NEON(const int8 *by, const int8 *cb, const int8 *cr, uint16x8_t *r, uint16x8_t *g, uint16x8_t *b)
+{
+   const int32x4_t round = vdupq_n_s32(0x80);
+   const int16x8_t min_s8 = vdupq_n_s16(-128);
+   const int16x8_t max_s8 = vdupq_n_s16(127);
+   const int16x8_t bias = vdupq_n_s16(0x80);
+   uint32 cb_raw, cr_raw;
+   int16x4_t cb16, cr16;
+   int16x4x2_t rz, gz, bz;
+   int32x4_t rt, gt, bt;
+   int16x8_t y, r16, g16, b16;
+
+   // Only the four samples covering the row; the rest of the chroma row may lie past the array.
+   memcpy(&cb_raw, cb, 4);
+   memcpy(&cr_raw, cr, 4);
+   cb16 = vget_low_s16(vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(cb_raw))));
+   cr16 = vget_low_s16(vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(cr_raw))));
+
+   rt = vshrq_n_s32(vaddq_s32(vmull_n_s16(cr16, 359), round), 8);
+
+   gt = vandq_s32(vmull_n_s16(cb16, -88), vdupq_n_s32(~0x1F));
+   gt = vaddq_s32(gt, vandq_s32(vmull_n_s16(cr16, -183), vdupq_n_s32(~0x07)));
+   gt = vshrq_n_s32(vaddq_s32(gt, round), 8);
+
+   bt = vshrq_n_s32(vaddq_s32(vmull_n_s16(cb16, 454), round), 8);
+
+   // Back to int16, each chroma term repeated for its two pixels.
+   rz = vzip_s16(vmovn_s32(rt), vmovn_s32(rt));
+   gz = vzip_s16(vmovn_s32(gt), vmovn_s32(gt));
+   bz = vzip_s16(vmovn_s32(bt), vmovn_s32(bt));
+
+   y = vmovl_s8(vld1_s8(by));
+
+   r16 = vaddq_s16(y, vcombine_s16(rz.val[0], rz.val[1]));
+   g16 = vaddq_s16(y, vcombine_s16(gz.val[0], gz.val[1]));
+   b16 = vaddq_s16(y, vcombine_s16(bz.val[0], bz.val[1]));
+
+   r16 = vshrq_n_s16(vshlq_n_s16(r16, 7), 7);
+   g16 = vshrq_n_s16(vshlq_n_s16(g16, 7), 7);
+   b16 = vshrq_n_s16(vshlq_n_s16(b16, 7), 7);
+
+   *r = vreinterpretq_u16_s16(vaddq_s16(vminq_s16(vmaxq_s16(r16, min_s8), max_s8), bias));
+   *g = vreinterpretq_u16_s16(vaddq_s16(vminq_s16(vmaxq_s16(g16, min_s8), max_s8), bias));
+   *b = vreinterpretq_u16_s16(vaddq_s16(vminq_s16(vmaxq_s16(b16, min_s8), max_s8), bias));
+}
+
+// RGB_to_RGB555() on eight pixels held as 0..255 uint16 lanes.
+static INLINE uint16x8_t RGB_to_RGB555_NEON(uint16x8_t r, uint16x8_t g, uint16x8_t b)
+{
+   const uint16x8_t four = vdupq_n_u16(4);
+   const uint16x8_t max5 = vdupq_n_u16(0x1F);
+
+   r = vminq_u16(vshrq_n_u16(vaddq_u16(r, four), 3), max5);
+   g = vminq_u16(vshrq_n_u16(vaddq_u16(g, four), 3), max5);
+   b = vminq_u16(vshrq_n_u16(vaddq_u16(b, four), 3), max5);
+
+   return vorrq_u16(r, vorrq_u16(vshlq_n_u16(g, 5), vshlq_n_u16(b, 10)));
+}
+#endif
+
 static void EncodeImage(const unsigned ybn)
 {
    int x, y;
@@ -455,7 +792,34 @@ static void EncodeImage(const unsigned ybn)
                const int8* by = &block_y[y][0];
                const int8* cb = &block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
                const int8* cr = &block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
+#if defined(__SSE2__)
+               uint8 rgb[3][8] MDFN_ALIGN(16);
+               const __m128i xor128 = _mm_set1_epi8((char)rgb_xor);
+               __m128i r, g, b;
+
+               YCbCr_to_RGB_Row_SSE2(by, cb, cr, &r, &g, &b);
+               _mm_store_si128((__m128i *)&rgb[0][0], _mm_xor_si128(_mm_packus_epi16(r, g), xor128));
+               _mm_storel_epi64((__m128i *)&rgb[2][0], _mm_xor_si128(_mm_packus_epi16(b, b), xor128));
 
+               for(x = 0; x < 8; x++)
+               {
+                  pix_out[0] = rgb[0][x];
+                  pix_out[1] = rgb[1][x];
+                  pix_out[2] = rgb[2][x];
+                  pix_out += 3;
+               }
+#elif defined(MDEC_NEON)
+               const uint8x8_t xor64 = vdup_n_u8(rgb_xor);
+               uint16x8_t r, g, b;
+               uint8x8x3_t rgb;
+
+               YCbCr_to_RGB_Row_NEON(by, cb, cr, &r, &g, &b);
+               rgb.val[0] = veor_u8(vmovn_u16(r), xor64);
+               rgb.val[1] = veor_u8(vmovn_u16(g), xor64);
+               rgb.val[2] = veor_u8(vmovn_u16(b), xor64);
+               vst3_u8(pix_out, rgb);
+               pix_out += 24;
+#else
                for(x = 0; x < 8; x++)
                {
                   int r, g, b;
@@ -467,6 +831,7 @@ static void EncodeImage(const unsigned ybn)
                   pix_out[2] = b ^ rgb_xor;
                   pix_out += 3;
                }
+#endif
             }
             PixelBufferCount32 = 48;
          }
@@ -482,7 +847,19 @@ static void EncodeImage(const unsigned ybn)
                const int8* by = &block_y[y][0];
                const int8* cb = &block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
                const int8* cr = &block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
+#if defined(__SSE2__)
+               __m128i r, g, b;
 
+               YCbCr_to_RGB_Row_SSE2(by, cb, cr, &r, &g, &b);
+               _mm_storeu_si128((__m128i *)pix_out, _mm_xor_si128(RGB_to_RGB555_SSE2(r, g, b), _mm_set1_epi16((short)pixel_xor)));
+               pix_out += 8;
+#elif defined(MDEC_NEON)
+               uint16x8_t r, g, b;
+
+               YCbCr_to_RGB_Row_NEON(by, cb, cr, &r, &g, &b);
+               vst1q_u16(pix_out, veorq_u16(RGB_to_RGB555_NEON(r, g, b), vdupq_n_u16(pixel_xor)));
+               pix_out += 8;
+#else
                for(x = 0; x < 8; x++)
                {
                   int r, g, b;
@@ -492,6 +869,7 @@ static void EncodeImage(const unsigned ybn)
                   StoreU16_LE(pix_out, pixel_xor ^ RGB_to_RGB555(r, g, b));
                   pix_out++;
                }
+#endif
             }
             PixelBufferCount32 = 32;
          }
@@ -626,7 +1004,7 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
 #define MDEC_READ_FIFO(n)  { MDEC_WAIT_COND(InFIFO->in_count); n = SimpleFIFO_ReadUnit(InFIFO); SimpleFIFO_ReadUnitIncrement(InFIFO); }
 #define MDEC_EAT_CLOCKS(n) { ClockCounter -= (n); MDEC_WAIT_COND(ClockCounter > 0); }
 
-void MDEC_Run(int32 clocks)
+static void MDEC_RunI(int32 clocks)
 {
    int i;
  static const unsigned MDRPhaseBias = __COUNTER__ + 1;
@@ -701,11 +1079,41 @@ void MDEC_Run(int32 clocks)
      WriteImageData(tfr, &need_eat);
      WriteImageData(tfr >> 16, &need_eat);
 
+     //
+     // Words that don't complete a block cost no clocks and produce no output, so
+     // as long as neither the clock budget nor the input would make us wait, keep
+     // decoding the rest of the macroblock here instead of going around the
+     // resumable loop once per word.
+     //
+     if(!need_eat && ClockCounter > 0)
+     {
+      PixelBufferReadOffset = 0;
+
+      while(!need_eat && InCounter != 0xFFFF && InFIFO->in_count)
+      {
+       tfr = SimpleFIFO_ReadUnit(InFIFO);
+       SimpleFIFO_ReadUnitIncrement(InFIFO);
+       InCounter--;
+
+       WriteImageData(tfr, &need_eat);
+       WriteImageData(tfr >> 16, &need_eat);
+      }
+     }
+
      MDEC_EAT_CLOCKS(need_eat);
 
      PixelBufferReadOffset = 0;
      while(PixelBufferReadOffset != PixelBufferCount32)
      {
+      while(PixelBufferReadOffset != PixelBufferCount32 && FIFO_CAN_WRITE(OutFIFO))
+      {
+       SimpleFIFO_WriteUnit(OutFIFO, LoadU32_LE(&PixelBuffer.pix32[PixelBufferReadOffset]));
+       PixelBufferReadOffset++;
+      }
+
+      if(PixelBufferReadOffset == PixelBufferCount32)
+       break;
+
       MDEC_WRITE_FIFO(LoadU32_LE(&PixelBuffer.pix32[PixelBufferReadOffset++]));
      }
     } while(InCounter != 0xFFFF);
@@ -770,12 +1178,28 @@ void MDEC_Run(int32 clocks)
 }
 #endif
 
+void MDEC_Run(int32 clocks)
+{
+ PSX_PROF_ENTER(PSX_PROF_MDEC);
+
+ if(clocks)
+  MDEC_CatchUp();
+
+ RunPending = false;
+ MDEC_RunI(clocks);
+
+ PSX_PROF_LEAVE();
+}
+
 void MDEC_DMAWrite(uint32 V)
 {
+ if(!FIFO_CAN_WRITE(InFIFO))
+  MDEC_CatchUp();
+
  if(FIFO_CAN_WRITE(InFIFO))
  {
   SimpleFIFO_WriteUnit(InFIFO, V);
-  MDEC_Run(0);
+  RunPending = true;
  }
 #if 0
  else
@@ -791,6 +1215,8 @@ uint32 MDEC_DMARead(int32* offs)
 
  *offs = 0;
 
+ MDEC_CatchUp();
+
  if(MDFN_LIKELY(OutFIFO->in_count))
  {
   V = SimpleFIFO_ReadUnit(OutFIFO);
@@ -821,19 +1247,26 @@ uint32 MDEC_DMARead(int32* offs)
 
 bool MDEC_DMACanWrite(void)
 {
+ MDEC_CatchUp();
+
  return((FIFO_CAN_WRITE(InFIFO) >= 0x20) && (MDECControl & (1U << 30)) && InCommand && InCounter != 0xFFFF);
 }
 
 bool MDEC_DMACanRead(void)
 {
    if (OutFIFO)
+   {
+      MDEC_CatchUp();
       return((OutFIFO->in_count >= 0x20) && (MDECControl & (1U << 29)));
+   }
    return false;
 }
 
 void MDEC_Write(const int32_t timestamp, uint32 A, uint32 V)
 {
  //PSX_WARNING("[MDEC] Write: 0x%08x 0x%08x, %d  --- %u %u", A, V, timestamp, InFIFO->in_count, OutFIFO->in_count);
+ MDEC_CatchUp();
+
  if(A & 4)
  {
   if(V & 0x80000000) // Reset?
@@ -885,6 +1318,8 @@ uint32 MDEC_Read(const int32_t timestamp, uint32 A)
 {
  uint32 ret = 0;
 
+ MDEC_CatchUp();
+
  if(A & 4)
  {
   ret = 0;
@@ -0,0 +1,130 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "profile.h"
+
+#ifdef PSX_PROFILE
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define PROF_MAX_DEPTH 16
+
+PSX_Counters PSX_Count;
+
+static uint64 ProfTime[PSX_PROF_COUNT];
+static uint64 ProfLast;
+static unsigned ProfStack[PROF_MAX_DEPTH];
+static unsigned ProfDepth;
+static unsigned ProfCurrent;
+
+static uint64 ProfNow(void)
+{
+#if defined(_WIN32)
+   static LARGE_INTEGER freq;
+   LARGE_INTEGER now;
+
+   if (!freq.QuadPart)
+      QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&now);
+
+   return (uint64)(now.QuadPart / freq.QuadPart) * 1000000000 + (uint64)(now.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#else
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void PSX_ProfEnter(unsigned section)
+{
+   const uint64 now = ProfNow();
+
+   ProfTime[ProfCurrent] += now - ProfLast;
+   ProfLast = now;
+
+   if (ProfDepth < PROF_MAX_DEPTH)
+      ProfStack[ProfDepth] = ProfCurrent;
+   ProfDepth++;
+   ProfCurrent = section;
+}
+
+void PSX_ProfLeave(void)
+{
+   const uint64 now = ProfNow();
+
+   ProfTime[ProfCurrent] += now - ProfLast;
+   ProfLast = now;
+
+   ProfDepth--;
+   ProfCurrent = (ProfDepth < PROF_MAX_DEPTH) ? ProfStack[ProfDepth] : ProfCurrent;
+}
+
+void PSX_ProfGet(uint64 ns[PSX_PROF_COUNT])
+{
+   const uint64 now = ProfNow();
+   unsigned i;
+
+   ProfTime[ProfCurrent] += now - ProfLast;
+   ProfLast = now;
+
+   for (i = 0; i < PSX_PROF_COUNT; i++)
+      ns[i] = ProfTime[i];
+}
+
+void PSX_ProfReset(void)
+{
+   unsigned i;
+
+   for (i = 0; i < PSX_PROF_COUNT; i++)
+      ProfTime[i] = 0;
+
+   ProfLast = ProfNow();
+}
+
+void PSX_ProfSave(PSX_ProfSnapshot *snap)
+{
+   PSX_ProfGet(snap->time);
+   snap->count = PSX_Count;
+}
+
+void PSX_ProfRestore(const PSX_ProfSnapshot *snap)
+{
+   const uint64 now = ProfNow();
+   unsigned i;
+   uint64 elapsed = now - ProfLast;
+
+   // Everything charged since the save goes to the section it interrupted.
+   for (i = 0; i < PSX_PROF_COUNT; i++)
+   {
+      elapsed += ProfTime[i] - snap->time[i];
+      ProfTime[i] = snap->time[i];
+   }
+
+   ProfTime[ProfCurrent] += elapsed;
+   ProfLast = now;
+
+   PSX_Count = snap->count;
+}
+
+#endif
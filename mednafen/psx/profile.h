@@ -0,0 +1,97 @@
+#ifndef __MDFN_PSX_PROFILE_H
+#define __MDFN_PSX_PROFILE_H
+
+#include <stdint.h>
+
+#include "../mednafen-types.h"
+
+//
+// Host time spent in each emulated subsystem, and counts of the work done on
+// their hot paths, for the headless benchmark runner(tools/psxbench.cpp) and
+// retro_psx_get_counters().  Only compiled in with PSX_PROFILE; otherwise the
+// PSX_PROF_*() and PSX_COUNT() macros expand to nothing.
+//
+// Times are exclusive: entering a section charges the time elapsed so far to
+// the section it interrupts(e.g. CDC_Update() calling SPU_UpdateFromCDC(),
+// or GPU_Update() being called from inside CPU->Run()), so the sections add
+// up to the total.  Time outside every section is PSX_PROF_OTHER.
+//
+enum
+{
+   PSX_PROF_OTHER = 0,  // Frontend glue, video/audio output.
+   PSX_PROF_CPU,        // CPU->Run(), including GTE, timers, DMA and pad/memcard I/O.
+   PSX_PROF_GPU,        // GPU_Update()
+   PSX_PROF_SPU,        // SPU_UpdateFromCDC()
+   PSX_PROF_CDC,        // CDC_Update()
+   PSX_PROF_MDEC,       // MDEC_Run()
+
+   PSX_PROF_COUNT
+};
+
+#define PSX_PROF_EVENT_COUNT 8  // >= PSX_EVENT__COUNT
+
+typedef struct
+{
+   uint64 cpu_instructions;
+   uint64 cpu_icache_misses;      // I-cache line fills; uncached fetches aren't counted.
+
+   uint64 gpu_commands[256];      // GP0 commands executed, by opcode.
+   uint64 gpu_pixels;             // Pixels written to GPU RAM by drawing, fills, copies and uploads.
+
+   uint64 dma_words[7];           // Words transferred, by channel.
+
+   uint64 spu_samples;
+   uint64 spu_voice_samples;      // Sum over samples of the voices with a non-zero envelope.
+
+   uint64 cd_sectors;             // Sectors read from the disc image.
+   uint64 cd_xa_sectors;          // XA ADPCM sectors decoded.
+
+   uint64 events[PSX_PROF_EVENT_COUNT];  // PSX_EventHandler() dispatches, by PSX_EVENT_*.
+} PSX_Counters;
+
+// The counters and section times, set aside by PSX_ProfSave().
+typedef struct
+{
+   PSX_Counters count;
+   uint64 time[PSX_PROF_COUNT];
+} PSX_ProfSnapshot;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef PSX_PROFILE
+extern PSX_Counters PSX_Count;
+
+#define PSX_COUNT(counter, n) (PSX_Count.counter += (n))
+
+void PSX_ProfEnter(unsigned section);
+void PSX_ProfLeave(void);
+
+// Nanoseconds spent in each section since the last PSX_ProfReset().
+void PSX_ProfGet(uint64 ns[PSX_PROF_COUNT]);
+void PSX_ProfReset(void);
+
+// Work that shouldn't count(run-ahead's frames) goes between these: restoring
+// puts the counters back as saved and charges the time in between to the
+// section that was current when saving.
+void PSX_ProfSave(PSX_ProfSnapshot *snap);
+void PSX_ProfRestore(const PSX_ProfSnapshot *snap);
+
+#define PSX_PROF_ENTER(section) PSX_ProfEnter(section)
+#define PSX_PROF_LEAVE() PSX_ProfLeave()
+#define PSX_PROF_SAVE(snap) PSX_ProfSave(snap)
+#define PSX_PROF_RESTORE(snap) PSX_ProfRestore(snap)
+#else
+#define PSX_COUNT(counter, n)
+#define PSX_PROF_ENTER(section)
+#define PSX_PROF_LEAVE()
+#define PSX_PROF_SAVE(snap)
+#define PSX_PROF_RESTORE(snap)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -102,6 +102,8 @@ extern bool widescreen_hack;
 #include "irq.h"
 #include "gpu.h"
 #include "dma.h"
+#include "dirty.h"
+#include "profile.h"
 //#include "sio.h"
 #include "debug.h"
 
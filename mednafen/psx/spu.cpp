@@ -73,9 +73,18 @@
 #include "spu.h"
 #include "../../libretro.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 uint32_t IntermediateBufferPos;
 int16_t IntermediateBuffer[4096][2];
 
+extern struct retro_perf_callback perf_cb;
+
+static SPU_Stats Stats;
+static bool StatsTiming;
+
 static uint32_t RWAddr;
 static uint16_t SPUControl;
 static uint16_t SPURAM[524288 / sizeof(uint16)];
@@ -108,6 +117,8 @@ static uint32_t BlockEnd;
 
 static uint32_t CWA;
 
+static void SPU_ResetADPCMCache(void);
+
 union
 {
    uint16_t Regs[0x100];
@@ -464,6 +475,7 @@ void SPU_Power(void)
  clock_divider = 768;
 
  memset(SPURAM, 0, sizeof(SPURAM));
+ PSX_DirtyMarkAll(PSX_DIRTY_SPURAM);
 
  for(int i = 0; i < 24; i++)
  {
@@ -505,6 +517,8 @@ void SPU_Power(void)
   memset(&Voices[i].ADSR, 0, sizeof(SPU_ADSR));
  }
 
+ SPU_ResetADPCMCache();
+
  GlobalSweep[0].Control = 0;
  GlobalSweep[0].Current = 0;
  GlobalSweep[0].Divider = 0;
@@ -645,22 +659,169 @@ static void SPU_Sweep_Clock(SPU_Sweep *sweep)
  }
 }
 
+// 5 through 0xF appear to be 0 on the real thing.
+static const int32 Weights[16][2] =
+{
+ // s-1    s-2
+ {   0,    0 },
+ {  60,    0 },
+ { 115,  -52 },
+ {  98,  -55 },
+ { 122,  -60 },
+};
+
 //
-// Take care not to trigger SPU IRQ for the next block before its decoding start.
+// Decoded ADPCM block cache.
 //
-static void SPU_RunDecoder(SPU_Voice *voice)
+// The 28 samples of a block depend only on its 7 data words, the shift/weight latched from its header, and the two filter history
+// samples at the start of the block.  Looped music replays the same blocks with the same history over and over, so each block is
+// decoded whole on first use and later plays just copy from here.  Any write into a block drops its entry(SPU_InvalidateADPCMCache()),
+// and SPU_RunDecoder() still steps through SPU RAM 4 samples at a time(IRQ checks included), so output is identical to the uncached path.
+//
+enum
 {
- // 5 through 0xF appear to be 0 on the real thing.
- static const int32 Weights[16][2] =
+ ADPCM_CACHE_SIZE = 2048,	// Power of 2; direct-mapped on block address.
+ ADPCM_CACHE_INVALID = 0xFFFFFFFF
+};
+
+struct SPU_ADPCMBlock
+{
+ uint32 BlockAddr;
+ uint32 Serial;		// 0 when invalid; voices compare it against DecodeCacheSerial to detect eviction mid-block.
+
+ int16 M2;
+ int16 M1;
+ uint8 Shift;
+ uint8 Weight;
+
+ int16 Samples[28];
+};
+
+static SPU_ADPCMBlock ADPCMCache[ADPCM_CACHE_SIZE];
+static uint32 ADPCMCacheSerial;
+
+static INLINE void SPU_InvalidateADPCMCache(uint32 addr)
+{
+ SPU_ADPCMBlock *ent = &ADPCMCache[(addr >> 3) & (ADPCM_CACHE_SIZE - 1)];
+
+ if(ent->BlockAddr == (addr & 0x3FFF8))
  {
-  // s-1    s-2
-  {   0,    0 },
-  {  60,    0 },
-  { 115,  -52 },
-  {  98,  -55 },
-  { 122,  -60 },
- };
+  ent->BlockAddr = ADPCM_CACHE_INVALID;
+  ent->Serial = 0;
+ }
+}
+
+static void SPU_ResetADPCMCache(void)
+{
+ for(unsigned i = 0; i < ADPCM_CACHE_SIZE; i++)
+ {
+  ADPCMCache[i].BlockAddr = ADPCM_CACHE_INVALID;
+  ADPCMCache[i].Serial = 0;
+ }
+
+ ADPCMCacheSerial = 0;
+
+ for(unsigned i = 0; i < 24; i++)
+ {
+  Voices[i].DecodeCacheIndex = 0;
+  Voices[i].DecodeCacheSerial = 0;
+ }
+}
+
+// Expands the 28 nibbles of the block at block_addr to (int16)(nibble << 12) >> shift, in playback order.
+static INLINE void SPU_UnpackADPCMBlock(uint32 block_addr, unsigned shift, int16 *out)
+{
+#if defined(__SSE2__)
+ // Loads the header word along with the 7 data words; its 4 bogus "samples" end up in tmp[0...3] and are skipped.
+ int16 tmp[32] MDFN_ALIGN(16);
+ const __m128i w = _mm_loadu_si128((const __m128i *)&SPURAM[block_addr]);
+ const __m128i sc = _mm_cvtsi32_si128(shift);
+ const __m128i hm = _mm_set1_epi16((int16)0xF000);
+ const __m128i n0 = _mm_sra_epi16(_mm_slli_epi16(w, 12), sc);
+ const __m128i n1 = _mm_sra_epi16(_mm_and_si128(_mm_slli_epi16(w, 8), hm), sc);
+ const __m128i n2 = _mm_sra_epi16(_mm_and_si128(_mm_slli_epi16(w, 4), hm), sc);
+ const __m128i n3 = _mm_sra_epi16(_mm_and_si128(w, hm), sc);
+ const __m128i lo01 = _mm_unpacklo_epi16(n0, n1);
+ const __m128i hi01 = _mm_unpackhi_epi16(n0, n1);
+ const __m128i lo23 = _mm_unpacklo_epi16(n2, n3);
+ const __m128i hi23 = _mm_unpackhi_epi16(n2, n3);
+
+ _mm_store_si128((__m128i *)&tmp[0], _mm_unpacklo_epi32(lo01, lo23));
+ _mm_store_si128((__m128i *)&tmp[8], _mm_unpackhi_epi32(lo01, lo23));
+ _mm_store_si128((__m128i *)&tmp[16], _mm_unpacklo_epi32(hi01, hi23));
+ _mm_store_si128((__m128i *)&tmp[24], _mm_unpackhi_epi32(hi01, hi23));
+
+ memcpy(out, &tmp[4], 28 * sizeof(int16));
+#else
+ for(unsigned i = 0; i < 7; i++)
+ {
+  uint32 coded = (uint32)SPURAM[block_addr + 1 + i] << 12;
+
+  for(unsigned j = 0; j < 4; j++)
+  {
+   out[(i << 2) + j] = (int16)(coded & 0xF000) >> shift;
+   coded >>= 4;
+  }
+ }
+#endif
+}
+
+static void SPU_DecodeADPCMBlock(SPU_ADPCMBlock *ent)
+{
+ const int32 weight_m1 = Weights[ent->Weight][0];
+ const int32 weight_m2 = Weights[ent->Weight][1];
+ int32 m2 = ent->M2;
+ int32 m1 = ent->M1;
+
+ SPU_UnpackADPCMBlock(ent->BlockAddr, ent->Shift, ent->Samples);
+
+ for(unsigned i = 0; i < 28; i++)
+ {
+  int32 sample = ent->Samples[i];
+
+  sample += ((m2 * weight_m2) >> 6);
+  sample += ((m1 * weight_m1) >> 6);
 
+  clamp(&sample, -32768, 32767);
+
+  ent->Samples[i] = sample;
+  m2 = m1;
+  m1 = sample;
+ }
+}
+
+// Called at the header of each block, after DecodeShift and DecodeWeight have been latched.
+static INLINE void SPU_LookupADPCMBlock(SPU_Voice *voice, uint32 block_addr)
+{
+ const uint32 index = (block_addr >> 3) & (ADPCM_CACHE_SIZE - 1);
+ SPU_ADPCMBlock *ent = &ADPCMCache[index];
+
+ if(ent->BlockAddr != block_addr || ent->M2 != voice->DecodeM2 || ent->M1 != voice->DecodeM1 ||
+    ent->Shift != voice->DecodeShift || ent->Weight != voice->DecodeWeight)
+ {
+  ent->BlockAddr = block_addr;
+  ent->M2 = voice->DecodeM2;
+  ent->M1 = voice->DecodeM1;
+  ent->Shift = voice->DecodeShift;
+  ent->Weight = voice->DecodeWeight;
+
+  SPU_DecodeADPCMBlock(ent);
+
+  if(!++ADPCMCacheSerial)
+   ADPCMCacheSerial++;
+
+  ent->Serial = ADPCMCacheSerial;
+ }
+
+ voice->DecodeCacheIndex = index;
+ voice->DecodeCacheSerial = ent->Serial;
+}
+
+//
+// Take care not to trigger SPU IRQ for the next block before its decoding start.
+//
+static void SPU_RunDecoder(SPU_Voice *voice)
+{
  if(voice->DecodeAvail >= 11)
  {
   if(SPUControl & 0x40)
@@ -731,6 +892,9 @@ static void SPU_RunDecoder(SPU_Voice *voice)
     }
 #endif
    }
+
+   SPU_LookupADPCMBlock(voice, voice->CurAddr);
+
    voice->CurAddr = (voice->CurAddr + 1) & 0x3FFFF;
   }
 
@@ -738,6 +902,23 @@ static void SPU_RunDecoder(SPU_Voice *voice)
   // Don't else this block; we need to ALWAYS decode 4 samples per call to RunDecoder() if DecodeAvail < 11, or else sample playback
   // at higher rates will fail horribly.
   //
+  if(voice->DecodeCacheSerial && ADPCMCache[voice->DecodeCacheIndex].Serial == voice->DecodeCacheSerial)
+  {
+   const int16 *src = &ADPCMCache[voice->DecodeCacheIndex].Samples[((voice->CurAddr & 0x7) - 1) << 2];
+   int16 *tb = &voice->DecodeBuffer[voice->DecodeWritePos];
+
+   tb[0] = src[0];
+   tb[1] = src[1];
+   tb[2] = src[2];
+   tb[3] = src[3];
+   voice->DecodeM2 = src[2];
+   voice->DecodeM1 = src[3];
+
+   voice->DecodeWritePos = (voice->DecodeWritePos + 4) & 0x1F;
+   voice->DecodeAvail += 4;
+   voice->CurAddr = (voice->CurAddr + 1) & 0x3FFFF;
+  }
+  else
   {
      const uint16 CV = SPURAM[voice->CurAddr];
    const unsigned shift = voice->DecodeShift;
@@ -891,6 +1072,8 @@ static INLINE void WriteSPURAM(uint32 addr, uint16 value)
 {
    CheckIRQAddr(addr);
 
+   SPU_InvalidateADPCMCache(addr);
+   PSX_DirtyMark(PSX_DIRTY_SPURAM, addr << 1);
    SPURAM[addr] = value;
 }
 
@@ -942,7 +1125,14 @@ static int32_t SPU_Get_Reverb_Offset(int32_t in_offset)
 
 #define RD_RVB(raw_offs) ((int16)SPURAM[SPU_Get_Reverb_Offset((raw_offs) << 2)])
 
-#define WR_RVB(raw_offs, sample, extra_offs) SPURAM[SPU_Get_Reverb_Offset(((raw_offs) << 2) + (extra_offs))] = ReverbSat((sample))
+static INLINE void WriteReverbRAM(int32_t offset, int32_t sample)
+{
+   SPU_InvalidateADPCMCache(offset);
+   PSX_DirtyMark(PSX_DIRTY_SPURAM, offset << 1);
+   SPURAM[offset] = ReverbSat(sample);
+}
+
+#define WR_RVB(raw_offs, sample, extra_offs) WriteReverbRAM(SPU_Get_Reverb_Offset(((raw_offs) << 2) + (extra_offs)), (sample))
 
 static INLINE int32_t Reverb4422(const int16_t *src)
 {
@@ -1125,12 +1315,21 @@ static INLINE void SPU_RunNoise(void)
    }
 }
 
+// CD audio samples fetched from the CDC at a time.
+#define SPU_CDA_BLOCK 64
+
 int32 SPU_UpdateFromCDC(int32 clocks)
 {
  //int32 clocks = timestamp - lastts;
  int32 sample_clocks = 0;
+ int32 cda_block[SPU_CDA_BLOCK][2];
+ unsigned cda_pos = 0;
+ unsigned cda_count = 0;
+ const retro_perf_tick_t start_ticks = StatsTiming ? perf_cb.get_perf_counter() : 0;
  //lastts = timestamp;
 
+ PSX_PROF_ENTER(PSX_PROF_SPU);
+
  clock_divider -= clocks;
 
  while(clock_divider <= 0)
@@ -1158,6 +1357,7 @@ int32 SPU_UpdateFromCDC(int32 clocks)
   int32 output_r = 0;
 
   const uint32 PhaseModCache = FM_Mode & ~ 1;
+  uint32 active_voices = 0;
 /*
 **
 ** 0x1F801DAE Notes and Conjecture:
@@ -1225,6 +1425,7 @@ int32 SPU_UpdateFromCDC(int32 clocks)
 
    voice_pvs = (voice_pvs * (int16)voice->ADSR.EnvLevel) >> 15;
    voice->PreLRSample = voice_pvs;
+   active_voices += (voice->ADSR.EnvLevel != 0);
 
    if(voice_num == 1 || voice_num == 3)
    {
@@ -1325,6 +1526,12 @@ int32 SPU_UpdateFromCDC(int32 clocks)
   VoiceOff = 0;
   VoiceOn = 0; 
 
+  if(active_voices > Stats.PeakActiveVoices)
+   Stats.PeakActiveVoices = active_voices;
+
+  PSX_COUNT(spu_samples, 1);
+  PSX_COUNT(spu_voice_samples, active_voices);
+
   // "Mute" control doesn't seem to affect CD audio(though CD audio reverb wasn't tested...)
   // TODO: If we add sub-sample timing accuracy, see if it's checked for every channel at different times, or just once.
   if(!(SPUControl & 0x4000))
@@ -1337,11 +1544,18 @@ int32 SPU_UpdateFromCDC(int32 clocks)
 
   // Get CD-DA
   {
-   int32 cda_raw[2];
+   int32 *cda_raw;
    int32 cdav[2];
 
-   CDC_GetCDAudio(cda_raw);	// PS_CDC::GetCDAudio() guarantees the variables passed by reference will be set to 0,
-				// and that their range shall be -32768 through 32767.
+   // CDC_GetCDAudioBlock() guarantees every sample will be set, even if just to 0, and that their range shall be
+   // -32768 through 32767.  The CDC can't run until we return, so rendering ahead within this call is safe.
+   if(cda_pos == cda_count)
+   {
+    cda_count = (sample_clocks < SPU_CDA_BLOCK) ? sample_clocks : SPU_CDA_BLOCK;
+    cda_pos = 0;
+    CDC_GetCDAudioBlock(cda_block, cda_count);
+   }
+   cda_raw = cda_block[cda_pos++];
 
    WriteSPURAM(CWA | 0x000, cda_raw[0]);
    WriteSPURAM(CWA | 0x200, cda_raw[1]);
@@ -1397,7 +1611,10 @@ int32 SPU_UpdateFromCDC(int32 clocks)
    IntermediateBuffer[IntermediateBufferPos][0] = output_l;
    IntermediateBuffer[IntermediateBufferPos][1] = output_r;
    IntermediateBufferPos++;
+   Stats.SamplesProduced++;
   }
+  else
+   Stats.SamplesDropped++;
 
   sample_clocks--;
 
@@ -1408,9 +1625,25 @@ int32 SPU_UpdateFromCDC(int32 clocks)
 
  //assert(clock_divider < 768);
 
+ if(StatsTiming)
+  Stats.HostTicks += perf_cb.get_perf_counter() - start_ticks;
+
+ PSX_PROF_LEAVE();
+
  return clock_divider;
 }
 
+void SPU_SetStatsTiming(bool enabled)
+{
+ StatsTiming = enabled && perf_cb.get_perf_counter;
+}
+
+void SPU_GetStats(SPU_Stats *stats)
+{
+ *stats = Stats;
+ memset(&Stats, 0, sizeof(Stats));
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -2655,7 +2888,7 @@ int SPU_StateAction(StateMem *sm, int load, int data_only)
 
   { &((clock_divider)), sizeof((clock_divider)), 0x80000000 | 0, "clock_divider" },
 
-  { ((SPURAM)), (uint32)(((524288 / sizeof(uint16))) * sizeof(uint16)), 0x20000000 | 0, "SPURAM" },
+  { ((SPURAM)), (uint32)(((524288 / sizeof(uint16))) * sizeof(uint16)), 0x20000000 | MDFNSTATE_TRACKED | PSX_DIRTY_SPURAM, "SPURAM" },
   { 0, 0, 0, 0 }
  };
  int ret = 1;
@@ -2673,6 +2906,8 @@ int SPU_StateAction(StateMem *sm, int load, int data_only)
   RDSB_WP &= 0x3F;
   RUSB_WP &= 0x3F;
 
+  SPU_ResetADPCMCache();
+
   IRQ_Assert(IRQ_SPU, IRQAsserted);
  }
 
@@ -2686,6 +2921,8 @@ uint16 SPU_PeekSPURAM(uint32 address)
 
 void SPU_PokeSPURAM(uint32 address, uint16 value)
 {
+ SPU_InvalidateADPCMCache(address & 0x3FFFF);
+ PSX_DirtyMark(PSX_DIRTY_SPURAM, (address & 0x3FFFF) << 1);
  SPURAM[address & 0x3FFFF] = value;
 }
 
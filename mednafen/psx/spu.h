@@ -137,6 +137,10 @@ struct SPU_Voice
  uint8 DecodeWeight;
  uint8_t DecodeFlags;
 
+ // Pre-decoded block cache slot for the block being played(not saved in save states; ADPCMCache serials are host-side only).
+ uint32 DecodeCacheIndex;
+ uint32 DecodeCacheSerial;
+
  SPU_Sweep Sweep[2];
 
  uint16_t Pitch;
@@ -175,6 +179,18 @@ int32_t SPU_EndFrame(int16 *SoundBuf);
 
 int32_t SPU_UpdateFromCDC(int32_t clocks);
 
+// Audio health counters, accumulated since the previous SPU_GetStats() call.
+struct SPU_Stats
+{
+ uint32 SamplesProduced;
+ uint32 SamplesDropped;		// Lost to the 4096-sample IntermediateBuffer cap.
+ uint32 PeakActiveVoices;	// Most voices with a non-zero envelope level during any one sample.
+ uint64 HostTicks;		// retro_perf ticks spent in SPU_UpdateFromCDC(); only counted when timing is enabled.
+};
+
+void SPU_SetStatsTiming(bool enabled);
+void SPU_GetStats(SPU_Stats *stats);	// Copies the counters out and clears them.
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,6 +30,8 @@ uint32_t setting_psx_multitap_port_1 = 0;
 uint32_t setting_psx_multitap_port_2 = 0;
 uint32_t setting_psx_analog_toggle = 0;
 uint32_t setting_psx_fastboot = 1;
+uint32_t setting_cdrom_chd_hunk_cache = 64;
+uint32_t setting_cd_load_into_ram = 0;
 
 bool MDFN_SaveSettings(const char *path)
 {
@@ -40,6 +42,8 @@ uint64 MDFN_GetSettingUI(const char *name)
 {
    if (!strcmp("psx.spu.resamp_quality", name)) /* make configurable */
       return 4;
+   if (!strcmp("cdrom.chd_hunk_cache", name))
+      return setting_cdrom_chd_hunk_cache;
 
    fprintf(stderr, "unhandled setting UI: %s\n", name);
    return 0;
@@ -76,7 +80,7 @@ bool MDFN_GetSettingB(const char *name)
       return 0;
    /* LIBRETRO */
    if (!strcmp("libretro.cd_load_into_ram", name))
-      return 0;
+      return setting_cd_load_into_ram;
    if (!strcmp("psx.input.port1.memcard", name))
       return 1;
    if (!strcmp("psx.input.port2.memcard", name))
@@ -3,6 +3,9 @@
 
 #include "mednafen-types.h"
 
+struct StateHasher;
+struct StateTracked;
+
 typedef struct
 {
    uint8 *data;
@@ -10,6 +13,10 @@ typedef struct
    uint32 len;
    uint32 malloced;
    uint32 initial_malloc; // A setting!
+   uint32 fast;           // Fixed-layout raw chunks instead of the portable format; see MDFNSS_StateAction().
+   uint32 size_only;      // Writes only advance loc/len; used to measure a state without building it.
+   struct StateHasher *hasher; // Saving hands each section to the hasher instead of writing it; see state_hash.h.
+   struct StateTracked *tracked; // Fast states hand the dirty-tracked memories to this instead of copying them.
 } StateMem;
 
 typedef struct
@@ -23,6 +30,20 @@ typedef struct
    //uint32 struct_size;	// Only used for MDFNSTATE_ARRAYOFS, sizeof(struct) that members of the linked SFORMAT struct are in.
 } SFORMAT;
 
+typedef struct StateHasher
+{
+   int (*section)(struct StateHasher *hasher, SFORMAT *sf, const char *name);
+} StateHasher;
+
+// Keeps the MDFNSTATE_TRACKED entries(MainRAM, GPURAM and SPURAM) out of a fast state; the
+// callback gets each one's number from its flags and saves or restores whatever it needs of it
+// itself.  Loading such a state leaves the dirty page marks alone, since the callback knows what
+// it put back.
+typedef struct StateTracked
+{
+   void (*region)(struct StateTracked *tracked, unsigned region, uint8 *data, int load);
+} StateTracked;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
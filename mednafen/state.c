@@ -38,6 +38,14 @@ int32 smem_read(StateMem* st, void* buffer, uint32 len)
 
 int32 smem_write(StateMem* st, void* buffer, uint32 len)
 {
+   if (st->size_only)
+   {
+      st->loc += len;
+      if (st->loc > st->len)
+         st->len = st->loc;
+      return (len);
+   }
+
    if ((len + st->loc) > st->malloced)
    {
       uint32 newsize = (st->malloced >= 32768) ? st->malloced :
@@ -264,6 +272,15 @@ static SFORMAT* FindSF(const char* name, SFORMAT* sf)
 }
 
 
+// The tracked memory an entry of a fast state holds, if st->tracked takes care of it, or -1.
+static int TrackedRegion(StateMem* st, SFORMAT* sf)
+{
+   if (!st->tracked || !(sf->flags & MDFNSTATE_TRACKED))
+      return -1;
+
+   return sf->flags & MDFNSTATE_TRACKED_MASK;
+}
+
 // Fast raw chunk reader
 static void DOReadChunk(StateMem* st, SFORMAT* sf)
 {
@@ -292,7 +309,12 @@ static void DOReadChunk(StateMem* st, SFORMAT* sf)
       if (sf->flags & MDFNSTATE_BOOL)
          bytesize *= sizeof(bool);
 
-      smem_read(st, (uint8*)sf->v, bytesize);
+      int region = TrackedRegion(st, sf);
+
+      if (region >= 0)
+         st->tracked->region(st->tracked, region, (uint8*)sf->v, 1);
+      else
+         smem_read(st, (uint8*)sf->v, bytesize);
       sf++;
    }
 }
@@ -378,6 +400,135 @@ static int ReadStateChunk(StateMem* st, SFORMAT* sf, int size)
    return 1;
 }
 
+// Fast raw chunk writer, the counterpart of DOReadChunk().
+static void DOWriteChunk(StateMem* st, SFORMAT* sf)
+{
+   while (sf->size || sf->name)
+   {
+      if (!sf->size || !sf->v)
+      {
+         sf++;
+         continue;
+      }
+
+      if (sf->size == (uint32) ~0) // Link to another SFORMAT struct
+      {
+         DOWriteChunk(st, (SFORMAT*)sf->v);
+         sf++;
+         continue;
+      }
+
+      int32 bytesize = sf->size;
+
+      if (sf->flags & MDFNSTATE_BOOL)
+         bytesize *= sizeof(bool);
+
+      int region = TrackedRegion(st, sf);
+
+      if (region >= 0)
+         st->tracked->region(st->tracked, region, (uint8*)sf->v, 0);
+      else
+         smem_write(st, (uint8*)sf->v, bytesize);
+      sf++;
+   }
+}
+
+/*
+ * Fast chunks are a 32-bit FNV-1a hash of the section name and of every
+ * entry's size and flags, the payload length, and then DOWriteChunk() output.
+ * Entries are matched by position rather than by name, and nothing is byte
+ * swapped, so such states only load into the same build on the same kind of
+ * host; the hash is what turns a layout change into a clean load failure.
+ * Entries handed to st->tracked are hashed but take no space in the payload.
+ */
+static uint32 FastHashU32(uint32 hash, uint32 v)
+{
+   unsigned i;
+
+   for (i = 0; i < 4; i++, v >>= 8)
+      hash = (hash ^ (v & 0xFF)) * 0x01000193;
+
+   return hash;
+}
+
+static void FastChunkLayout(StateMem* st, SFORMAT* sf, uint32* hash, uint32* size)
+{
+   while (sf->size || sf->name)
+   {
+      if (!sf->size || !sf->v)
+      {
+         sf++;
+         continue;
+      }
+
+      if (sf->size == (uint32) ~0) // Link to another SFORMAT struct
+      {
+         FastChunkLayout(st, (SFORMAT*)sf->v, hash, size);
+         sf++;
+         continue;
+      }
+
+      uint32 bytesize = sf->size;
+
+      if (sf->flags & MDFNSTATE_BOOL)
+         bytesize *= sizeof(bool);
+
+      *hash = FastHashU32(FastHashU32(*hash, bytesize), sf->flags);
+
+      if (TrackedRegion(st, sf) < 0)
+         *size += bytesize;
+      sf++;
+   }
+}
+
+static uint32 FastChunkHeader(StateMem* st, const char* sname, SFORMAT* sf, uint32* size)
+{
+   uint32 hash = 0x811C9DC5;
+   unsigned i;
+
+   for (i = 0; i < 32 && sname[i]; i++)
+      hash = (hash ^ (uint8)sname[i]) * 0x01000193;
+
+   *size = 0;
+   FastChunkLayout(st, sf, &hash, size);
+
+   return hash;
+}
+
+static int WriteFastChunk(StateMem* st, const char* sname, SFORMAT* sf)
+{
+   uint32 size;
+   uint32 hash = FastChunkHeader(st, sname, sf, &size);
+
+   smem_write32le(st, hash);
+   smem_write32le(st, size);
+   DOWriteChunk(st, sf);
+
+   return 1;
+}
+
+static int ReadFastChunk(StateMem* st, const char* sname, SFORMAT* sf)
+{
+   uint32 size, recorded_hash, recorded_size;
+   uint32 hash = FastChunkHeader(st, sname, sf, &size);
+
+   if (!smem_read32le(st, &recorded_hash) || !smem_read32le(st, &recorded_size))
+   {
+      puts("Unexpected EOF");
+      return 0;
+   }
+
+   if (recorded_hash != hash || recorded_size != size || (st->len - st->loc) < size)
+   {
+      printf("Fast state section layout mismatch: %.32s\n", sname);
+      return 0;
+   }
+
+   DOReadChunk(st, sf);
+
+   return 1;
+}
+
 static int CurrentState = 0;
 
 /* This function is called by the game driver(NES, GB, GBA) to save a state. */
@@ -385,6 +536,13 @@ static int CurrentState = 0;
 int MDFNSS_StateAction(void* st_p, int load, SFORMAT* sf, const char* name)
 {
    StateMem* st = (StateMem*)st_p;
+
+   if (st->hasher && !load)
+      return st->hasher->section(st->hasher, sf, name);
+
+   if (st->fast)
+      return load ? ReadFastChunk(st, name, sf) : WriteFastChunk(st, name, sf);
+
    if (load)
    {
       char sname[32];
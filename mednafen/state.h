@@ -31,6 +31,12 @@ int smem_read32le(StateMem *st, uint32 *b);
 
 #define MDFNSTATE_BOOL		  0x08000000
 
+// Memory whose writes its owner tracks, so a fast state with StateMem::tracked set hands it to
+// that instead of copying it(see StateTracked).  The low bits say which memory, numbered as
+// the owner likes: MDFNSTATE_TRACKED | PSX_DIRTY_GPURAM, say.
+#define MDFNSTATE_TRACKED         0x04000000
+#define MDFNSTATE_TRACKED_MASK    0x000000FF
+
 #ifdef __cplusplus
 }
 #endif
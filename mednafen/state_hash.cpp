@@ -0,0 +1,320 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mednafen.h"
+#include "state.h"
+#include "state_hash.h"
+#include "psx/dirty.h"
+
+#include <string.h>
+
+//
+// XXH64, streaming.  Four independent 64-bit lanes over 32-byte stripes, which is what
+// makes it fast; inputs are read in host byte order.
+//
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+typedef struct
+{
+ uint64 v[4];
+ uint64 total_len;
+ uint8 mem[32];
+ uint32 memsize;
+} XXH64_State;
+
+static INLINE uint64 Rotl64(uint64 x, unsigned r)
+{
+ return (x << r) | (x >> (64 - r));
+}
+
+static INLINE uint64 Read64(const uint8 *p)
+{
+ uint64 v;
+
+ memcpy(&v, p, 8);
+ return v;
+}
+
+static INLINE uint32 Read32(const uint8 *p)
+{
+ uint32 v;
+
+ memcpy(&v, p, 4);
+ return v;
+}
+
+static INLINE uint64 XXH64_Round(uint64 acc, uint64 input)
+{
+ acc += input * PRIME64_2;
+ acc = Rotl64(acc, 31);
+ return acc * PRIME64_1;
+}
+
+static INLINE uint64 XXH64_MergeRound(uint64 acc, uint64 val)
+{
+ acc ^= XXH64_Round(0, val);
+ return acc * PRIME64_1 + PRIME64_4;
+}
+
+static void XXH64_Reset(XXH64_State *s, uint64 seed)
+{
+ s->v[0] = seed + PRIME64_1 + PRIME64_2;
+ s->v[1] = seed + PRIME64_2;
+ s->v[2] = seed;
+ s->v[3] = seed - PRIME64_1;
+ s->total_len = 0;
+ s->memsize = 0;
+}
+
+static const uint8 *XXH64_Stripes(uint64 *v, const uint8 *p, const uint8 *limit)
+{
+ uint64 v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
+
+ while(p <= limit)
+ {
+  v0 = XXH64_Round(v0, Read64(p + 0));
+  v1 = XXH64_Round(v1, Read64(p + 8));
+  v2 = XXH64_Round(v2, Read64(p + 16));
+  v3 = XXH64_Round(v3, Read64(p + 24));
+  p += 32;
+ }
+
+ v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+
+ return p;
+}
+
+static void XXH64_Update(XXH64_State *s, const void *data, uint32 len)
+{
+ const uint8 *p = (const uint8 *)data;
+ const uint8 *end = p + len;
+
+ s->total_len += len;
+
+ if(s->memsize + len < 32)
+ {
+  memcpy(s->mem + s->memsize, p, len);
+  s->memsize += len;
+  return;
+ }
+
+ if(s->memsize)
+ {
+  memcpy(s->mem + s->memsize, p, 32 - s->memsize);
+  p += 32 - s->memsize;
+  XXH64_Stripes(s->v, s->mem, s->mem);
+  s->memsize = 0;
+ }
+
+ if(end - p >= 32)
+  p = XXH64_Stripes(s->v, p, end - 32);
+
+ memcpy(s->mem, p, end - p);
+ s->memsize = end - p;
+}
+
+static uint64 XXH64_Digest(const XXH64_State *s)
+{
+ const uint8 *p = s->mem;
+ const uint8 *end = p + s->memsize;
+ uint64 h;
+
+ if(s->total_len >= 32)
+ {
+  h = Rotl64(s->v[0], 1) + Rotl64(s->v[1], 7) + Rotl64(s->v[2], 12) + Rotl64(s->v[3], 18);
+  h = XXH64_MergeRound(h, s->v[0]);
+  h = XXH64_MergeRound(h, s->v[1]);
+  h = XXH64_MergeRound(h, s->v[2]);
+  h = XXH64_MergeRound(h, s->v[3]);
+ }
+ else
+  h = s->v[2] + PRIME64_5;
+
+ h += s->total_len;
+
+ for(; p + 8 <= end; p += 8)
+ {
+  h ^= XXH64_Round(0, Read64(p));
+  h = Rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+ }
+
+ if(p + 4 <= end)
+ {
+  h ^= (uint64)Read32(p) * PRIME64_1;
+  h = Rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+  p += 4;
+ }
+
+ for(; p < end; p++)
+ {
+  h ^= *p * PRIME64_5;
+  h = Rotl64(h, 11) * PRIME64_1;
+ }
+
+ h ^= h >> 33;
+ h *= PRIME64_2;
+ h ^= h >> 29;
+ h *= PRIME64_3;
+ h ^= h >> 32;
+
+ return h;
+}
+
+static uint64 XXH64(const void *data, uint32 len, uint64 seed)
+{
+ XXH64_State s;
+
+ XXH64_Reset(&s, seed);
+ XXH64_Update(&s, data, len);
+
+ return XXH64_Digest(&s);
+}
+
+//
+// The big memories are hashed as the hash of their page hashes, whether or not the cache was
+// used, so incremental and full hashes agree.
+//
+#define MAX_PAGES ((2048 * 1024) >> PSX_DIRTY_PAGE_SHIFT)
+
+static uint64 PageHashes[PSX_DIRTY_REGION_COUNT][MAX_PAGES];
+
+static MDFNSH_Section Sections[MDFNSH_MAX_SECTIONS];
+static unsigned SectionCount = 0;
+
+typedef struct
+{
+ StateHasher base;
+ bool full;
+} Hasher;
+
+static void HashRegion(XXH64_State *s, unsigned region, const uint8 *data, bool full)
+{
+ const uint32 count = PSX_DirtyPageCount(region);
+ uint64 *hashes = PageHashes[region];
+
+ PSX_DirtyEnable(region, PSX_DIRTY_USER_STATE_HASH, true);
+
+ for(uint32 i = 0; i < count; i++)
+ {
+  if(full || PSX_DirtyTest(region, PSX_DIRTY_USER_STATE_HASH, i))
+   hashes[i] = XXH64(data + (i << PSX_DIRTY_PAGE_SHIFT), PSX_DIRTY_PAGE_SIZE, 0);
+ }
+
+ PSX_DirtyReset(region, PSX_DIRTY_USER_STATE_HASH);
+
+ XXH64_Update(s, hashes, count * sizeof(uint64));
+}
+
+static void HashEntries(XXH64_State *s, SFORMAT *sf, bool full)
+{
+ while(sf->size || sf->name)
+ {
+  if(!sf->size || !sf->v)
+  {
+   sf++;
+   continue;
+  }
+
+  if(sf->size == (uint32)~0) // Link to another SFORMAT struct
+  {
+   HashEntries(s, (SFORMAT *)sf->v, full);
+   sf++;
+   continue;
+  }
+
+  if(sf->flags & MDFNSTATE_BOOL)
+  {
+   // As 0/1 bytes, whatever sizeof(bool) and the representation of true are.
+   for(uint32 i = 0; i < sf->size; i++)
+   {
+    const uint8 b = ((bool *)sf->v)[i];
+    XXH64_Update(s, &b, 1);
+   }
+  }
+  else
+  {
+   if(sf->flags & MDFNSTATE_TRACKED)
+    HashRegion(s, sf->flags & MDFNSTATE_TRACKED_MASK, (const uint8 *)sf->v, full);
+   else
+    XXH64_Update(s, sf->v, sf->size);
+  }
+
+  sf++;
+ }
+}
+
+static int HashSection(StateHasher *base, SFORMAT *sf, const char *name)
+{
+ Hasher *h = (Hasher *)base;
+ XXH64_State s;
+
+ if(SectionCount == MDFNSH_MAX_SECTIONS)
+  return 0;
+
+ XXH64_Reset(&s, 0);
+ HashEntries(&s, sf, h->full);
+
+ MDFNSH_Section *sec = &Sections[SectionCount++];
+ memset(sec->name, 0, sizeof(sec->name));
+ strncpy(sec->name, name, sizeof(sec->name) - 1);
+ sec->hash = XXH64_Digest(&s);
+
+ return 1;
+}
+
+uint64 MDFNSH_Hash(bool full)
+{
+ Hasher h;
+ StateMem st;
+ XXH64_State s;
+
+ memset(&st, 0, sizeof(st));
+ h.base.section = HashSection;
+ h.full = full;
+ st.hasher = &h.base;
+
+ SectionCount = 0;
+
+ if(!MDFNGameInfo->StateAction(&st, 0, 0))
+ {
+  SectionCount = 0;
+  return 0;
+ }
+
+ XXH64_Reset(&s, 0);
+ XXH64_Update(&s, Sections, SectionCount * sizeof(Sections[0]));
+
+ return XXH64_Digest(&s);
+}
+
+unsigned MDFNSH_GetSections(const MDFNSH_Section **sections)
+{
+ *sections = Sections;
+ return SectionCount;
+}
+
+void MDFNSH_Kill(void)
+{
+ for(unsigned i = 0; i < PSX_DIRTY_REGION_COUNT; i++)
+  PSX_DirtyEnable(i, PSX_DIRTY_USER_STATE_HASH, false);
+
+ SectionCount = 0;
+}
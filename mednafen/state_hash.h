@@ -0,0 +1,34 @@
+#ifndef __MDFN_STATE_HASH_H
+#define __MDFN_STATE_HASH_H
+
+#include "mednafen-types.h"
+
+// Per-frame fingerprints of the emulator state, for replay and lockstep desync detection.
+// Every SFORMAT section the state code walks is hashed separately with XXH64, and the
+// section hashes are hashed again into one 64-bit value.  MainRAM, GPURAM and SPURAM are
+// hashed as 4KiB pages whose hashes are cached and only recomputed for pages the dirty
+// tracking(psx/dirty.h) saw written, so an unchanged state costs little more than the
+// small sections.
+//
+// Values depend on the build's state layout and on host endianness, like fast savestates.
+
+#define MDFNSH_MAX_SECTIONS 64
+
+typedef struct
+{
+ char name[32];
+ uint64 hash;
+} MDFNSH_Section;
+
+// Hashes the current state; call between frames.  "full" rehashes every page instead of
+// trusting the cache(the result is the same unless memory was changed behind the emulator's
+// back).  Returns 0 if the state walk failed.
+uint64 MDFNSH_Hash(bool full);
+
+// The per-section breakdown of the last MDFNSH_Hash(), in state order.
+unsigned MDFNSH_GetSections(const MDFNSH_Section **sections);
+
+// Stops dirty tracking and drops the cache.
+void MDFNSH_Kill(void);
+
+#endif
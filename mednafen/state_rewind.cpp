@@ -0,0 +1,324 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mednafen.h"
+#include "state.h"
+#include "state_rewind.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <deque>
+#include <vector>
+
+//
+// The newest snapshot is kept whole in Snap[CurSnap].  Every entry in History is the XOR of
+// two consecutive snapshots, so applying the newest entry to the current snapshot yields the
+// one before it, and so on back.  Consecutive snapshots are mostly identical(the bulk is
+// MainRAM, GPURAM and SPURAM), so deltas are stored as alternating runs of unchanged 64-bit
+// words and XOR words:
+//
+//  varint zero_words, varint xor_words, xor_words * 8 bytes, ...
+//
+// Dropping the oldest entry only shortens the history, which is what the memory budget does.
+//
+
+static bool Enabled = false;
+static unsigned Interval = 1;
+static uint64 Budget = 0;
+static unsigned FrameCounter = 0;
+
+static StateMem Snap[2];
+static unsigned CurSnap = 0;
+static bool HaveSnap = false;
+
+static uint8 *EncodeBuf = NULL;
+static size_t EncodeBufSize = 0;
+
+static std::deque< std::vector<uint8> > History;
+static uint64 HistoryBytes = 0;
+
+static INLINE uint8 *PutVarint(uint8 *p, uint32 v)
+{
+ while(v >= 0x80)
+ {
+  *p++ = (v & 0x7F) | 0x80;
+  v >>= 7;
+ }
+ *p++ = v;
+
+ return p;
+}
+
+static INLINE const uint8 *GetVarint(const uint8 *p, const uint8 *end, uint32 *v)
+{
+ unsigned shift = 0;
+
+ *v = 0;
+ while(p < end && shift < 32)
+ {
+  const uint8 b = *p++;
+
+  *v |= (uint32)(b & 0x7F) << shift;
+  if(!(b & 0x80))
+   break;
+  shift += 7;
+ }
+
+ return p;
+}
+
+static size_t EncodeDelta(const uint64 *prev, const uint64 *cur, size_t words, uint8 *out)
+{
+ uint8 *p = out;
+ size_t i = 0;
+
+ while(i < words)
+ {
+  const size_t zero_start = i;
+  size_t xor_start;
+
+  while(i < words && prev[i] == cur[i])
+   i++;
+
+  xor_start = i;
+
+  while(i < words && prev[i] != cur[i])
+   i++;
+
+  p = PutVarint(p, (uint32)(xor_start - zero_start));
+  p = PutVarint(p, (uint32)(i - xor_start));
+
+  for(size_t j = xor_start; j < i; j++)
+  {
+   const uint64 x = prev[j] ^ cur[j];
+
+   memcpy(p, &x, sizeof(x));
+   p += sizeof(x);
+  }
+ }
+
+ return p - out;
+}
+
+static void ApplyDelta(uint64 *state, size_t words, const uint8 *p, const uint8 *end)
+{
+ size_t i = 0;
+
+ while(p < end)
+ {
+  uint32 zero_words, xor_words;
+
+  p = GetVarint(p, end, &zero_words);
+  p = GetVarint(p, end, &xor_words);
+
+  i += zero_words;
+
+  if(i > words || xor_words > (words - i) || (size_t)(end - p) < (size_t)xor_words * 8)
+   break;
+
+  while(xor_words--)
+  {
+   uint64 x;
+
+   memcpy(&x, p, sizeof(x));
+   state[i++] ^= x;
+   p += sizeof(x);
+  }
+ }
+}
+
+// Pads a snapshot out to whole 64-bit words with zeroes, so deltas can work a word at a time.
+static bool PadSnap(StateMem *st)
+{
+ const uint32 padded = (st->len + 7) &~ 7;
+
+ if(st->malloced < padded)
+ {
+  uint8 *data = (uint8 *)realloc(st->data, padded);
+
+  if(!data)
+   return false;
+
+  st->data = data;
+  st->malloced = padded;
+ }
+
+ memset(st->data + st->len, 0, padded - st->len);
+
+ return true;
+}
+
+static void TrimHistory(void)
+{
+ while(HistoryBytes > Budget && !History.empty())
+ {
+  HistoryBytes -= History.front().size();
+  History.pop_front();
+ }
+}
+
+void MDFNSRW_Clear(void)
+{
+ History.clear();
+ HistoryBytes = 0;
+ HaveSnap = false;
+ FrameCounter = 0;
+}
+
+void MDFNSRW_Kill(void)
+{
+ unsigned i;
+
+ MDFNSRW_Clear();
+
+ for(i = 0; i < 2; i++)
+ {
+  if(Snap[i].data)
+   free(Snap[i].data);
+  memset(&Snap[i], 0, sizeof(Snap[i]));
+ }
+
+ if(EncodeBuf)
+  free(EncodeBuf);
+ EncodeBuf = NULL;
+ EncodeBufSize = 0;
+}
+
+void MDFNSRW_Configure(bool enable, unsigned interval, uint64 budget)
+{
+ if(!interval)
+  interval = 1;
+
+ if(!enable)
+ {
+  if(Enabled)
+   MDFNSRW_Kill();
+ }
+ else if(!Enabled || interval != Interval)
+  MDFNSRW_Clear();
+
+ Enabled = enable;
+ Interval = interval;
+ Budget = budget;
+
+ TrimHistory();
+}
+
+void MDFNSRW_Frame(void)
+{
+ StateMem *prev, *cur;
+ size_t words;
+
+ if(!Enabled || !MDFNGameInfo)
+  return;
+
+ if(++FrameCounter < Interval)
+  return;
+
+ FrameCounter = 0;
+
+ prev = &Snap[CurSnap];
+ cur = &Snap[CurSnap ^ 1];
+
+ cur->loc = 0;
+ cur->len = 0;
+ cur->fast = 1;
+
+ if(!MDFNGameInfo->StateAction(cur, 0, 0) || !PadSnap(cur))
+ {
+  MDFNSRW_Clear();
+  return;
+ }
+
+ words = (cur->len + 7) / 8;
+
+ if(HaveSnap && prev->len == cur->len)
+ {
+  const size_t max_size = words * 8 + (words + 1) * 10;
+  size_t size;
+
+  if(EncodeBufSize < max_size)
+  {
+   uint8 *buf = (uint8 *)realloc(EncodeBuf, max_size);
+
+   if(!buf)
+   {
+    MDFNSRW_Clear();
+    return;
+   }
+
+   EncodeBuf = buf;
+   EncodeBufSize = max_size;
+  }
+
+  size = EncodeDelta((const uint64 *)prev->data, (const uint64 *)cur->data, words, EncodeBuf);
+
+  History.push_back(std::vector<uint8>(EncodeBuf, EncodeBuf + size));
+  HistoryBytes += size;
+  TrimHistory();
+ }
+ else
+ {
+  // First snapshot, or the layout changed under us; either way there's nothing to chain to.
+  History.clear();
+  HistoryBytes = 0;
+ }
+
+ CurSnap ^= 1;
+ HaveSnap = true;
+}
+
+bool MDFNSRW_Rewind(void)
+{
+ StateMem *cur = &Snap[CurSnap];
+ StateMem st;
+
+ if(!Enabled || !HaveSnap || !MDFNGameInfo)
+  return false;
+
+ memset(&st, 0, sizeof(st));
+ st.data = cur->data;
+ st.len = cur->len;
+ st.malloced = cur->malloced;
+ st.fast = 1;
+
+ if(!MDFNGameInfo->StateAction(&st, MEDNAFEN_VERSION_NUMERIC, 0))
+ {
+  MDFNSRW_Clear();
+  return false;
+ }
+
+ if(!History.empty())
+ {
+  const std::vector<uint8> &delta = History.back();
+
+  ApplyDelta((uint64 *)cur->data, (cur->len + 7) / 8, &delta[0], &delta[0] + delta.size());
+
+  HistoryBytes -= delta.size();
+  History.pop_back();
+ }
+
+ FrameCounter = 0;
+
+ return true;
+}
+
+void MDFNSRW_GetStats(uint32 *snapshots, uint64 *bytes)
+{
+ *snapshots = HaveSnap ? (uint32)History.size() + 1 : 0;
+ *bytes = HistoryBytes + Snap[0].malloced + Snap[1].malloced + EncodeBufSize;
+}
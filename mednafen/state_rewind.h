@@ -0,0 +1,31 @@
+#ifndef __MDFN_STATE_REWIND_H
+#define __MDFN_STATE_REWIND_H
+
+#include "mednafen-types.h"
+
+// In-memory rewind history.  Snapshots use the fixed-layout ("fast") state format and are
+// kept as XOR deltas against the snapshot that follows them, zero-run encoded.
+
+// Enables/disables capturing; a snapshot is taken every "interval" frames, and the oldest
+// history is dropped once the encoded deltas would exceed "budget" bytes.
+void MDFNSRW_Configure(bool enable, unsigned interval, uint64 budget);
+
+// Drops all history(call after anything that makes the current state discontinuous, like
+// loading a state or resetting).
+void MDFNSRW_Clear(void);
+
+// Frees everything, including the snapshot buffers.
+void MDFNSRW_Kill(void);
+
+// Call once per emulated frame, between frames, while not rewinding.
+void MDFNSRW_Frame(void);
+
+// Restores the most recent snapshot and steps the history back by one, so that repeated
+// calls walk backwards in time.  Returns false if rewinding is disabled or there is
+// no snapshot yet.
+bool MDFNSRW_Rewind(void);
+
+// Number of snapshots that can still be rewound to, and the memory held for them.
+void MDFNSRW_GetStats(uint32 *snapshots, uint64 *bytes);
+
+#endif
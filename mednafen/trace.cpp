@@ -0,0 +1,301 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "mednafen.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "../libretro.h"
+
+extern retro_log_printf_t log_cb;
+
+struct Trace_Span
+{
+ const char *name;
+ uint64 start;
+ uint64 end;
+ int64 arg;
+};
+
+enum
+{
+ TRACE_CHUNK_SPANS = 8192,
+ TRACE_MAX_QUEUED = 64		// Chunks waiting for the writer, ~16MiB; beyond that spans are dropped.
+};
+
+bool MDFNTR_Active = false;
+
+static FILE *Trace_File = NULL;
+static uint64 Trace_Origin;
+static std::vector<Trace_Span> Trace_Chunk;	// Being filled by the emulation thread.
+static uint64 Trace_Dropped;
+
+uint64 MDFNTR_Now(void)
+{
+#if defined(_WIN32)
+ static LARGE_INTEGER freq;
+ LARGE_INTEGER now;
+
+ if(!freq.QuadPart)
+  QueryPerformanceFrequency(&freq);
+ QueryPerformanceCounter(&now);
+
+ return (uint64)(now.QuadPart / freq.QuadPart) * 1000000000 + (uint64)(now.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#else
+ struct timespec ts;
+
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+
+ return (uint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+// Appends v in decimal; with frac, as v / 1000 with three decimals.
+static char *Trace_PutNum(char *p, uint64 v, bool frac)
+{
+ char tmp[24];
+ int n = 0;
+
+ do
+ {
+  tmp[n++] = '0' + (v % 10);
+  v /= 10;
+
+  if(frac && n == 3)
+   tmp[n++] = '.';
+ } while(v || (frac && n < 5));
+
+ while(n)
+  *p++ = tmp[--n];
+
+ return p;
+}
+
+// printf() is too slow to keep up with event spans; format by hand.
+static void Trace_WriteChunk(const std::vector<Trace_Span> &chunk)
+{
+ static const char head[] = ",\n{\"name\":\"";
+ static const char mid[] = "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":";
+ static const char dur[] = ",\"dur\":";
+ static const char args[] = ",\"args\":{\"n\":";
+
+ for(size_t i = 0; i < chunk.size(); i++)
+ {
+  const Trace_Span &s = chunk[i];
+  const size_t name_len = strlen(s.name);
+  char line[256];
+  char *p = line;
+
+  if(name_len > 64)
+   continue;
+
+  memcpy(p, head, sizeof(head) - 1); p += sizeof(head) - 1;
+  memcpy(p, s.name, name_len); p += name_len;
+  memcpy(p, mid, sizeof(mid) - 1); p += sizeof(mid) - 1;
+  p = Trace_PutNum(p, s.start - Trace_Origin, true);
+  memcpy(p, dur, sizeof(dur) - 1); p += sizeof(dur) - 1;
+  p = Trace_PutNum(p, s.end - s.start, true);
+
+  if(s.arg >= 0)
+  {
+   memcpy(p, args, sizeof(args) - 1); p += sizeof(args) - 1;
+   p = Trace_PutNum(p, s.arg, false);
+   *p++ = '}';
+  }
+
+  *p++ = '}';
+
+  fwrite(line, 1, p - line, Trace_File);
+ }
+}
+
+#ifdef WANT_THREADING
+static std::deque< std::vector<Trace_Span> > Trace_Queue;
+static bool Trace_Quit;
+
+static MDFN_Thread *Trace_Thread = NULL;
+static MDFN_Mutex *Trace_Mutex = NULL;
+static MDFN_Cond *Trace_WorkCond = NULL;
+
+static int Trace_ThreadMain(void *data)
+{
+ MDFND_LockMutex(Trace_Mutex);
+
+ for(;;)
+ {
+  while(Trace_Queue.empty() && !Trace_Quit)
+   MDFND_WaitCond(Trace_WorkCond, Trace_Mutex);
+
+  if(Trace_Queue.empty())
+   break;
+
+  std::vector<Trace_Span> chunk;
+
+  chunk.swap(Trace_Queue.front());
+  Trace_Queue.pop_front();
+  MDFND_UnlockMutex(Trace_Mutex);
+
+  Trace_WriteChunk(chunk);
+
+  MDFND_LockMutex(Trace_Mutex);
+ }
+
+ MDFND_UnlockMutex(Trace_Mutex);
+
+ return 0;
+}
+#endif
+
+// Hands the filled chunk to the writer.
+static void Trace_Submit(void)
+{
+ if(Trace_Chunk.empty())
+  return;
+
+#ifdef WANT_THREADING
+ if(Trace_Thread)
+ {
+  MDFND_LockMutex(Trace_Mutex);
+
+  if(Trace_Queue.size() >= TRACE_MAX_QUEUED)
+   Trace_Dropped += Trace_Chunk.size();
+  else
+  {
+   Trace_Queue.push_back(std::vector<Trace_Span>());
+   Trace_Queue.back().swap(Trace_Chunk);
+   MDFND_SignalCond(Trace_WorkCond);
+  }
+
+  MDFND_UnlockMutex(Trace_Mutex);
+
+  Trace_Chunk.clear();
+  Trace_Chunk.reserve(TRACE_CHUNK_SPANS);
+  return;
+ }
+#endif
+
+ Trace_WriteChunk(Trace_Chunk);
+ Trace_Chunk.clear();
+}
+
+bool MDFNTR_Start(const char *path)
+{
+ MDFNTR_Stop();
+
+ if(!(Trace_File = fopen(path, "w")))
+ {
+  if(log_cb)
+   log_cb(RETRO_LOG_ERROR, "Error opening trace \"%s\" for writing.\n", path);
+  return false;
+ }
+
+ fprintf(Trace_File, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+ fprintf(Trace_File, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"emulation\"}}");
+
+ Trace_Origin = MDFNTR_Now();
+ Trace_Dropped = 0;
+ Trace_Chunk.clear();
+ Trace_Chunk.reserve(TRACE_CHUNK_SPANS);
+
+#ifdef WANT_THREADING
+ Trace_Quit = false;
+ Trace_Mutex = MDFND_CreateMutex();
+ Trace_WorkCond = MDFND_CreateCond();
+
+ if(!Trace_Mutex || !Trace_WorkCond || !(Trace_Thread = MDFND_CreateThread(Trace_ThreadMain, NULL)))
+ {
+  // Write from this thread instead.
+  if(Trace_WorkCond)
+   MDFND_DestroyCond(Trace_WorkCond);
+  if(Trace_Mutex)
+   MDFND_DestroyMutex(Trace_Mutex);
+  Trace_Mutex = NULL;
+  Trace_WorkCond = NULL;
+ }
+#endif
+
+ MDFNTR_Active = true;
+
+ return true;
+}
+
+void MDFNTR_Stop(void)
+{
+ if(!MDFNTR_Active)
+  return;
+
+ MDFNTR_Active = false;
+ Trace_Submit();
+
+#ifdef WANT_THREADING
+ if(Trace_Thread)
+ {
+  MDFND_LockMutex(Trace_Mutex);
+  Trace_Quit = true;
+  MDFND_SignalCond(Trace_WorkCond);
+  MDFND_UnlockMutex(Trace_Mutex);
+
+  MDFND_WaitThread(Trace_Thread, NULL);
+  Trace_Thread = NULL;
+
+  MDFND_DestroyCond(Trace_WorkCond);
+  MDFND_DestroyMutex(Trace_Mutex);
+  Trace_Mutex = NULL;
+  Trace_WorkCond = NULL;
+ }
+#endif
+
+ fprintf(Trace_File, "\n]}\n");
+
+ if(fclose(Trace_File) && log_cb)
+  log_cb(RETRO_LOG_ERROR, "Error writing trace.\n");
+ Trace_File = NULL;
+
+ if(Trace_Dropped && log_cb)
+  log_cb(RETRO_LOG_WARN, "Trace writer fell behind, %llu spans were dropped.\n", (unsigned long long)Trace_Dropped);
+
+ std::vector<Trace_Span>().swap(Trace_Chunk);
+}
+
+void MDFNTR_Add(const char *name, uint64 start, uint64 end, int64 arg)
+{
+ Trace_Span s;
+
+ if(start < Trace_Origin)	// Began before a restart.
+  return;
+
+ s.name = name;
+ s.start = start;
+ s.end = end;
+ s.arg = arg;
+
+ Trace_Chunk.push_back(s);
+
+ if(Trace_Chunk.size() >= TRACE_CHUNK_SPANS)
+  Trace_Submit();
+}
@@ -0,0 +1,39 @@
+#ifndef __MDFN_TRACE_H
+#define __MDFN_TRACE_H
+
+#include "mednafen-types.h"
+
+// Timeline tracing: spans of host time(the phases of a frame, event dispatches, ...) saved as a
+// Chrome trace JSON file, for chrome://tracing or https://ui.perfetto.dev.  Spans are buffered
+// in memory and formatted and written by a background thread(without WANT_THREADING, by the
+// caller whenever a buffer fills), so a traced span costs the emulation thread two clock reads
+// and a store.  Spans all belong to one thread and must nest properly.
+
+extern bool MDFNTR_Active;
+
+// Starts tracing to path, replacing any trace in progress.
+bool MDFNTR_Start(const char *path);
+
+// Writes out the spans still buffered and finishes the file.
+void MDFNTR_Stop(void);
+
+// Host time in nanoseconds.
+uint64 MDFNTR_Now(void);
+
+// name must stay valid until the trace is stopped(i.e. be a string constant); arg, if >= 0, is
+// shown as the span's "n" argument.
+void MDFNTR_Add(const char *name, uint64 start, uint64 end, int64 arg);
+
+// uint64 t = MDFNTR_Begin(); ...; MDFNTR_End("name", t);
+static INLINE uint64 MDFNTR_Begin(void)
+{
+ return MDFNTR_Active ? MDFNTR_Now() : 0;
+}
+
+static INLINE void MDFNTR_End(const char *name, uint64 start)
+{
+ if(MDFNTR_Active && start)
+  MDFNTR_Add(name, start, MDFNTR_Now(), -1);
+}
+
+#endif
@@ -0,0 +1,286 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Driver side of the threading support declared in mednafen/mednafen-driver.h. */
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+/* Condition variables came with Vista; older SDKs(msvc-2003) and XP targets get a semaphore-based
+ * version, which is enough for MDFND_WaitCond()/MDFND_SignalCond() since there's no broadcast. */
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0600
+#define HAVE_WIN32_CONDITION_VARIABLE
+#endif
+#else
+#include <pthread.h>
+#endif
+
+struct MDFN_Thread
+{
+#ifdef _WIN32
+   HANDLE thread;
+#else
+   pthread_t thread;
+#endif
+   int (*fn)(void *);
+   void *data;
+   int status;
+};
+
+struct MDFN_Mutex
+{
+#ifdef _WIN32
+   CRITICAL_SECTION lock;
+#else
+   pthread_mutex_t lock;
+#endif
+};
+
+struct MDFN_Cond
+{
+#if defined(HAVE_WIN32_CONDITION_VARIABLE)
+   CONDITION_VARIABLE cond;
+#elif defined(_WIN32)
+   CRITICAL_SECTION lock;  /* Guards waiting and signals. */
+   int waiting;            /* Threads in MDFND_WaitCond(). */
+   int signals;            /* Of those, how many have been signalled but not yet woken. */
+   HANDLE wait_sem;        /* Released once per signal. */
+   HANDLE wait_done;       /* Released by the woken thread, so the signaller doesn't return before it wakes. */
+#else
+   pthread_cond_t cond;
+#endif
+};
+
+#ifdef _WIN32
+static DWORD CALLBACK thread_wrap(void *data_)
+#else
+static void *thread_wrap(void *data_)
+#endif
+{
+   struct MDFN_Thread *thread = (struct MDFN_Thread*)data_;
+
+   thread->status = thread->fn(thread->data);
+
+   return 0;
+}
+
+struct MDFN_Thread *MDFND_CreateThread(int (*fn)(void *), void *data)
+{
+   struct MDFN_Thread *thread = (struct MDFN_Thread*)calloc(1, sizeof(*thread));
+
+   if (!thread)
+      return NULL;
+
+   thread->fn   = fn;
+   thread->data = data;
+
+#ifdef _WIN32
+   thread->thread = CreateThread(NULL, 0, thread_wrap, thread, 0, NULL);
+   if (!thread->thread)
+#else
+   if (pthread_create(&thread->thread, NULL, thread_wrap, thread) != 0)
+#endif
+   {
+      free(thread);
+      return NULL;
+   }
+
+   return thread;
+}
+
+void MDFND_WaitThread(struct MDFN_Thread *thread, int *status)
+{
+#ifdef _WIN32
+   WaitForSingleObject(thread->thread, INFINITE);
+   CloseHandle(thread->thread);
+#else
+   pthread_join(thread->thread, NULL);
+#endif
+
+   if (status)
+      *status = thread->status;
+
+   free(thread);
+}
+
+void MDFND_KillThread(struct MDFN_Thread *thread)
+{
+#ifdef _WIN32
+   TerminateThread(thread->thread, 0);
+   CloseHandle(thread->thread);
+#elif defined(ANDROID)
+   /* No pthread_cancel() in bionic; let the thread run to completion on its own. */
+   pthread_detach(thread->thread);
+#else
+   pthread_cancel(thread->thread);
+   pthread_join(thread->thread, NULL);
+#endif
+
+   free(thread);
+}
+
+struct MDFN_Mutex *MDFND_CreateMutex(void)
+{
+   struct MDFN_Mutex *mutex = (struct MDFN_Mutex*)calloc(1, sizeof(*mutex));
+
+   if (!mutex)
+      return NULL;
+
+#ifdef _WIN32
+   InitializeCriticalSection(&mutex->lock);
+#else
+   if (pthread_mutex_init(&mutex->lock, NULL) != 0)
+   {
+      free(mutex);
+      return NULL;
+   }
+#endif
+
+   return mutex;
+}
+
+void MDFND_DestroyMutex(struct MDFN_Mutex *mutex)
+{
+#ifdef _WIN32
+   DeleteCriticalSection(&mutex->lock);
+#else
+   pthread_mutex_destroy(&mutex->lock);
+#endif
+   free(mutex);
+}
+
+int MDFND_LockMutex(struct MDFN_Mutex *mutex)
+{
+#ifdef _WIN32
+   EnterCriticalSection(&mutex->lock);
+   return 0;
+#else
+   return pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+int MDFND_UnlockMutex(struct MDFN_Mutex *mutex)
+{
+#ifdef _WIN32
+   LeaveCriticalSection(&mutex->lock);
+   return 0;
+#else
+   return pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+struct MDFN_Cond *MDFND_CreateCond(void)
+{
+   struct MDFN_Cond *cond = (struct MDFN_Cond*)calloc(1, sizeof(*cond));
+
+   if (!cond)
+      return NULL;
+
+#if defined(HAVE_WIN32_CONDITION_VARIABLE)
+   InitializeConditionVariable(&cond->cond);
+#elif defined(_WIN32)
+   cond->wait_sem  = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+   cond->wait_done = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+
+   if (!cond->wait_sem || !cond->wait_done)
+   {
+      if (cond->wait_sem)
+         CloseHandle(cond->wait_sem);
+      if (cond->wait_done)
+         CloseHandle(cond->wait_done);
+      free(cond);
+      return NULL;
+   }
+
+   InitializeCriticalSection(&cond->lock);
+#else
+   if (pthread_cond_init(&cond->cond, NULL) != 0)
+   {
+      free(cond);
+      return NULL;
+   }
+#endif
+
+   return cond;
+}
+
+void MDFND_DestroyCond(struct MDFN_Cond *cond)
+{
+#if !defined(_WIN32)
+   pthread_cond_destroy(&cond->cond);
+#elif !defined(HAVE_WIN32_CONDITION_VARIABLE)
+   CloseHandle(cond->wait_sem);
+   CloseHandle(cond->wait_done);
+   DeleteCriticalSection(&cond->lock);
+#endif
+   free(cond);
+}
+
+int MDFND_WaitCond(struct MDFN_Cond *cond, struct MDFN_Mutex *mutex)
+{
+#if defined(HAVE_WIN32_CONDITION_VARIABLE)
+   return SleepConditionVariableCS(&cond->cond, &mutex->lock, INFINITE) ? 0 : -1;
+#elif defined(_WIN32)
+   DWORD ret;
+
+   EnterCriticalSection(&cond->lock);
+   cond->waiting++;
+   LeaveCriticalSection(&cond->lock);
+
+   LeaveCriticalSection(&mutex->lock);
+
+   ret = WaitForSingleObject(cond->wait_sem, INFINITE);
+
+   EnterCriticalSection(&cond->lock);
+   if (cond->signals > 0)
+   {
+      ReleaseSemaphore(cond->wait_done, 1, NULL);
+      cond->signals--;
+   }
+   cond->waiting--;
+   LeaveCriticalSection(&cond->lock);
+
+   EnterCriticalSection(&mutex->lock);
+
+   return (ret == WAIT_OBJECT_0) ? 0 : -1;
+#else
+   return pthread_cond_wait(&cond->cond, &mutex->lock);
+#endif
+}
+
+int MDFND_SignalCond(struct MDFN_Cond *cond)
+{
+#if defined(HAVE_WIN32_CONDITION_VARIABLE)
+   WakeConditionVariable(&cond->cond);
+   return 0;
+#elif defined(_WIN32)
+   EnterCriticalSection(&cond->lock);
+   if (cond->waiting > cond->signals)
+   {
+      cond->signals++;
+      ReleaseSemaphore(cond->wait_sem, 1, NULL);
+      LeaveCriticalSection(&cond->lock);
+      WaitForSingleObject(cond->wait_done, INFINITE);
+   }
+   else
+      LeaveCriticalSection(&cond->lock);
+   return 0;
+#else
+   return pthread_cond_signal(&cond->cond);
+#endif
+}
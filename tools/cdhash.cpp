@@ -0,0 +1,517 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ cdhash: verifies and hashes disc images with the core's image readers, without loading the emulator.
+
+	Usage: cdhash [-j threads] image...
+
+ For each disc(every disc of a multi-disc PBP), prints the MD5 and CRC32 of each track and of the whole disc, over the
+ 2352-byte sectors from LBA 0 up to the leadout as the core reads them(so e.g. the hashes of a CUE/BIN, CCD and CHD of the
+ same disc should match), and checks the EDC(and L-EC, when the EDC is wrong) of every data sector.  Runs of sectors that
+ needed L-EC repair or are unrecoverable are listed.
+
+ Sectors are read and checked by worker threads, each with its own CDAccess, in chunks handed out round-robin; the main
+ thread hashes the chunks in order.
+
+ Exit status is 0 if every image was read and all its sectors were good, 1 if there were bad sectors, and 2 if an image
+ couldn't be read at all.
+*/
+
+#include "mednafen/mednafen.h"
+#include "mednafen/error.h"
+#include "mednafen/md5.h"
+#include "mednafen/mednafen-driver.h"
+#include "mednafen/cdrom/CDAccess.h"
+#include "mednafen/cdrom/CDUtility.h"
+#include "mednafen/cdrom/dvdisaster.h"
+#include "libretro.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <string>
+
+using namespace CDUtility;
+
+// The core's sources log through the frontend; send warnings and errors to stderr.
+static void cdhash_log(enum retro_log_level level, const char *fmt, ...)
+{
+   va_list ap;
+
+   if (level < RETRO_LOG_WARN)
+      return;
+
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+retro_log_printf_t log_cb = cdhash_log;
+struct retro_perf_callback perf_cb;
+std::string retro_base_directory;
+std::string retro_base_name;
+
+enum
+{
+   CHUNK_SECTORS = 256,
+   MAX_THREADS = 64
+};
+
+enum
+{
+   SECT_OK = 0,
+   SECT_UNCHECKED,	// Audio, or mode 0.
+   SECT_REPAIRABLE,	// EDC mismatch that L-EC fixes.
+   SECT_BAD
+};
+
+static const char *const SectStatusNames[] = { "ok", "unchecked", "repairable", "unrecoverable" };
+
+struct HashJob;
+
+struct ChunkSlot
+{
+   bool ready;
+   uint8 data[CHUNK_SECTORS][2352];
+   uint8 status[CHUNK_SECTORS];
+};
+
+struct HashWorker
+{
+   HashJob *job;
+   unsigned index;
+   CDAccess *cda;
+   MDFN_Thread *thread;
+   MDFN_Cond *cond;		// Main -> worker: a slot was freed(or the job failed).
+   ChunkSlot slots[2];		// Chunk k goes to worker k % num_workers, slot (k / num_workers) & 1.
+};
+
+struct HashJob
+{
+   TOC toc;
+   uint32 num_sectors;
+   uint32 num_chunks;
+
+   unsigned num_workers;
+   HashWorker *workers[MAX_THREADS];
+
+   MDFN_Mutex *mutex;		// Protects the slots' ready flags, failed and error.
+   MDFN_Cond *main_cond;	// Worker -> main: a slot was filled(or the job failed).
+   bool failed;
+   std::string error;
+};
+
+static uint32 crc32_table[256];
+
+static void CRC32_Init(void)
+{
+   for (unsigned i = 0; i < 256; i++)
+   {
+      uint32 r = i;
+
+      for (unsigned j = 0; j < 8; j++)
+         r = (r & 1) ? ((r >> 1) ^ 0xEDB88320) : (r >> 1);
+
+      crc32_table[i] = r;
+   }
+}
+
+static uint32 CRC32_Update(uint32 crc, const uint8 *data, size_t len)
+{
+   crc = ~crc;
+
+   while (len--)
+      crc = crc32_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+   return ~crc;
+}
+
+static unsigned CheckSector(const uint8 *raw, bool data_track)
+{
+   static const uint8 sync[12] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+   const unsigned mode = raw[12 + 3];
+   uint8 tmp[2352];
+   bool xa;
+
+   if (!data_track)
+      return SECT_UNCHECKED;
+
+   if (memcmp(raw, sync, 12))
+      return SECT_BAD;
+
+   switch (mode)
+   {
+      case 0:
+         return SECT_UNCHECKED;
+
+      case 1:
+         xa = false;
+         break;
+
+      case 2:
+         if (raw[12 + 4 + 2] & 0x20)
+         {
+            // Form 2; the EDC is optional(0 if absent), and there's no L-EC.
+            const uint32 edc = raw[2348] | (raw[2349] << 8) | (raw[2350] << 16) | ((uint32)raw[2351] << 24);
+
+            if (!edc || EDCCrc32(raw + 16, 2332) == edc)
+               return SECT_OK;
+
+            return SECT_BAD;
+         }
+         xa = true;
+         break;
+
+      default:
+         return SECT_BAD;
+   }
+
+   if (edc_check(raw, xa))
+      return SECT_OK;
+
+   memcpy(tmp, raw, 2352);
+
+   return edc_lec_check_and_correct(tmp, xa) ? SECT_REPAIRABLE : SECT_BAD;
+}
+
+static void Job_Fail(HashJob *job, const char *message)
+{
+   MDFND_LockMutex(job->mutex);
+
+   if (!job->failed)
+   {
+      job->failed = true;
+      job->error = message;
+   }
+
+   MDFND_SignalCond(job->main_cond);
+   MDFND_UnlockMutex(job->mutex);
+}
+
+static int Worker_ThreadMain(void *data)
+{
+   HashWorker *w = (HashWorker *)data;
+   HashJob *job = w->job;
+
+   for (uint32 chunk = w->index; chunk < job->num_chunks; chunk += job->num_workers)
+   {
+      ChunkSlot *slot = &w->slots[(chunk / job->num_workers) & 1];
+      const uint32 first_lba = chunk * CHUNK_SECTORS;
+      const uint32 count = std::min<uint32>(CHUNK_SECTORS, job->num_sectors - first_lba);
+      bool failed;
+
+      MDFND_LockMutex(job->mutex);
+      while (slot->ready && !job->failed)
+         MDFND_WaitCond(w->cond, job->mutex);
+      failed = job->failed;
+      MDFND_UnlockMutex(job->mutex);
+
+      if (failed)
+         break;
+
+      try
+      {
+         for (uint32 i = 0; i < count; i++)
+         {
+            const uint32 lba = first_lba + i;
+            const int track = job->toc.FindTrackByLBA(lba);
+            uint8 buf[2352 + 96];
+
+            w->cda->Read_Raw_Sector(buf, lba);
+            memcpy(slot->data[i], buf, 2352);
+            slot->status[i] = CheckSector(buf, (job->toc.tracks[track].control & SUBQ_CTRLF_DATA) != 0);
+         }
+      }
+      catch (std::exception &e)
+      {
+         Job_Fail(job, e.what());
+         break;
+      }
+
+      MDFND_LockMutex(job->mutex);
+      slot->ready = true;
+      MDFND_SignalCond(job->main_cond);
+      MDFND_UnlockMutex(job->mutex);
+   }
+
+   return 0;
+}
+
+struct RangeReport
+{
+   unsigned status;
+   uint32 start;
+   uint32 counts[4];
+};
+
+static void Range_Flush(RangeReport *rr, uint32 end)
+{
+   if (rr->status == SECT_REPAIRABLE || rr->status == SECT_BAD)
+   {
+      if (end - 1 == rr->start)
+         printf("  LBA %u: %s\n", rr->start, SectStatusNames[rr->status]);
+      else
+         printf("  LBA %u-%u: %s\n", rr->start, end - 1, SectStatusNames[rr->status]);
+   }
+}
+
+static void Range_Add(RangeReport *rr, uint32 lba, unsigned status)
+{
+   rr->counts[status]++;
+
+   if (status != rr->status)
+   {
+      Range_Flush(rr, lba);
+      rr->status = status;
+      rr->start = lba;
+   }
+}
+
+// Returns 0 if the disc was good, 1 if it had bad sectors, 2 on error.
+static int HashDisc(const char *path, unsigned disc, unsigned disc_count, unsigned num_threads)
+{
+   HashJob job;
+   RangeReport rr;
+   md5_context disc_md5, track_md5;
+   uint32 disc_crc = 0, track_crc = 0;
+   int track = 0;
+   uint32 track_end = 0;
+   int ret = 0;
+
+   memset(&rr, 0, sizeof(rr));
+   rr.status = SECT_OK;
+
+   job.failed = false;
+   job.num_workers = 0;
+   job.mutex = MDFND_CreateMutex();
+   job.main_cond = MDFND_CreateCond();
+
+   if (disc_count > 1)
+      printf("%s (disc %u of %u)\n", path, disc + 1, disc_count);
+   else
+      printf("%s\n", path);
+
+   try
+   {
+      for (unsigned i = 0; i < num_threads; i++)
+      {
+         HashWorker *w = new HashWorker;
+
+         w->job = &job;
+         w->index = i;
+         w->cda = NULL;
+         w->thread = NULL;
+         w->cond = MDFND_CreateCond();
+         w->slots[0].ready = w->slots[1].ready = false;
+         job.workers[job.num_workers++] = w;
+
+         w->cda = cdaccess_open_image(path, false, disc);
+
+         if (!i)
+            w->cda->Read_TOC(&job.toc);
+      }
+   }
+   catch (std::exception &e)
+   {
+      Job_Fail(&job, e.what());
+   }
+
+   if (!job.failed)
+   {
+      job.num_sectors = job.toc.tracks[100].lba;
+      job.num_chunks = (job.num_sectors + CHUNK_SECTORS - 1) / CHUNK_SECTORS;
+
+      for (unsigned i = 0; i < job.num_workers; i++)
+      {
+         HashWorker *w = job.workers[i];
+
+         if (!(w->thread = MDFND_CreateThread(Worker_ThreadMain, w)))
+         {
+            Job_Fail(&job, "Error creating thread.");
+            break;
+         }
+      }
+   }
+
+   disc_md5.starts();
+
+   for (uint32 chunk = 0; !job.failed && chunk < job.num_chunks; chunk++)
+   {
+      HashWorker *w = job.workers[chunk % job.num_workers];
+      ChunkSlot *slot = &w->slots[(chunk / job.num_workers) & 1];
+      const uint32 first_lba = chunk * CHUNK_SECTORS;
+      const uint32 count = std::min<uint32>(CHUNK_SECTORS, job.num_sectors - first_lba);
+
+      MDFND_LockMutex(job.mutex);
+      while (!slot->ready && !job.failed)
+         MDFND_WaitCond(job.main_cond, job.mutex);
+      MDFND_UnlockMutex(job.mutex);
+
+      if (job.failed)
+         break;
+
+      for (uint32 i = 0; i < count; i++)
+      {
+         const uint32 lba = first_lba + i;
+
+         while (lba >= track_end)
+         {
+            if (track)
+            {
+               uint8 digest[16];
+
+               track_md5.finish(digest);
+               printf("  Track %02d %s  LBA %6u-%6u  CRC32 %08x  MD5 %s\n", track,
+                     (job.toc.tracks[track].control & SUBQ_CTRLF_DATA) ? "DATA " : "AUDIO",
+                     job.toc.tracks[track].lba, track_end - 1, track_crc, md5_context::asciistr(digest, 0).c_str());
+            }
+
+            track = track ? (track + 1) : job.toc.first_track;
+            track_end = (track < job.toc.last_track) ? job.toc.tracks[track + 1].lba : job.num_sectors;
+            track_md5.starts();
+            track_crc = 0;
+         }
+
+         disc_md5.update(slot->data[i], 2352);
+         track_md5.update(slot->data[i], 2352);
+         disc_crc = CRC32_Update(disc_crc, slot->data[i], 2352);
+         track_crc = CRC32_Update(track_crc, slot->data[i], 2352);
+
+         Range_Add(&rr, lba, slot->status[i]);
+      }
+
+      MDFND_LockMutex(job.mutex);
+      slot->ready = false;
+      MDFND_SignalCond(w->cond);
+      MDFND_UnlockMutex(job.mutex);
+   }
+
+   if (job.failed)
+   {
+      // Wake any worker waiting on a slot so it sees the failure.
+      MDFND_LockMutex(job.mutex);
+      for (unsigned i = 0; i < job.num_workers; i++)
+         MDFND_SignalCond(job.workers[i]->cond);
+      MDFND_UnlockMutex(job.mutex);
+   }
+
+   for (unsigned i = 0; i < job.num_workers; i++)
+   {
+      HashWorker *w = job.workers[i];
+
+      if (w->thread)
+         MDFND_WaitThread(w->thread, NULL);
+
+      if (w->cda)
+         delete w->cda;
+
+      MDFND_DestroyCond(w->cond);
+      delete w;
+   }
+
+   if (job.failed)
+   {
+      printf("  Error: %s\n", job.error.c_str());
+      ret = 2;
+   }
+   else
+   {
+      uint8 digest[16];
+
+      if (track)
+      {
+         track_md5.finish(digest);
+         printf("  Track %02d %s  LBA %6u-%6u  CRC32 %08x  MD5 %s\n", track,
+               (job.toc.tracks[track].control & SUBQ_CTRLF_DATA) ? "DATA " : "AUDIO",
+               job.toc.tracks[track].lba, track_end - 1, track_crc, md5_context::asciistr(digest, 0).c_str());
+      }
+
+      Range_Flush(&rr, job.num_sectors);
+
+      disc_md5.finish(digest);
+      printf("  Disc: %u sectors  CRC32 %08x  MD5 %s\n", job.num_sectors, disc_crc, md5_context::asciistr(digest, 0).c_str());
+      printf("  Sectors: %u ok, %u unchecked, %u repairable, %u unrecoverable\n",
+            rr.counts[SECT_OK], rr.counts[SECT_UNCHECKED], rr.counts[SECT_REPAIRABLE], rr.counts[SECT_BAD]);
+
+      if (rr.counts[SECT_REPAIRABLE] || rr.counts[SECT_BAD])
+         ret = 1;
+   }
+
+   MDFND_DestroyCond(job.main_cond);
+   MDFND_DestroyMutex(job.mutex);
+
+   return ret;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned num_threads = 4;
+   int ret = 0;
+   int i;
+
+   for (i = 1; i < argc && argv[i][0] == '-'; i++)
+   {
+      if (!strcmp(argv[i], "-j") && (i + 1) < argc)
+      {
+         num_threads = atoi(argv[++i]);
+
+         if (num_threads < 1)
+            num_threads = 1;
+         else if (num_threads > MAX_THREADS)
+            num_threads = MAX_THREADS;
+      }
+      else
+         break;
+   }
+
+   if (i >= argc)
+   {
+      fprintf(stderr, "Usage: %s [-j threads] image...\n", argv[0]);
+      return 2;
+   }
+
+   CRC32_Init();
+
+   for (; i < argc; i++)
+   {
+      unsigned disc_count;
+      int disc_ret;
+
+      try
+      {
+         disc_count = cdaccess_get_disc_count(argv[i]);
+      }
+      catch (std::exception &e)
+      {
+         printf("%s\n  Error: %s\n", argv[i], e.what());
+         ret = 2;
+         continue;
+      }
+
+      for (unsigned disc = 0; disc < disc_count; disc++)
+      {
+         disc_ret = HashDisc(argv[i], disc, disc_count, num_threads);
+
+         if (disc_ret > ret)
+            ret = disc_ret;
+      }
+   }
+
+   return ret;
+}
@@ -0,0 +1,32 @@
+// Core sources used by the cdhash tool; built the same way as beetle_psx_griffin.cpp.
+
+#include "mednafen/error.cpp"
+#include "mednafen/settings.cpp"
+#include "mednafen/general.cpp"
+#include "mednafen/FileStream.cpp"
+#include "mednafen/MemoryStream.cpp"
+#include "mednafen/MMapStream.cpp"
+#include "mednafen/Stream.cpp"
+
+#include "mednafen/cdrom/CDAccess.cpp"
+#include "mednafen/cdrom/CDAccess_Image.cpp"
+#include "mednafen/cdrom/CDAccess_CCD.cpp"
+#include "mednafen/cdrom/CDAccess_Memory.cpp"
+#ifdef HAVE_CHD
+#include "mednafen/cdrom/CDAccess_CHD.cpp"
+#endif
+#ifdef HAVE_ZLIB
+#include "mednafen/cdrom/CDAccess_PBP.cpp"
+#endif
+#include "mednafen/cdrom/CDUtility.cpp"
+#include "mednafen/cdrom/lec.cpp"
+#include "mednafen/cdrom/audioreader.cpp"
+#ifdef HAVE_FLAC
+#include "mednafen/cdrom/audioreader_flac.cpp"
+#endif
+#ifdef HAVE_WAVPACK
+#include "mednafen/cdrom/audioreader_wavpack.cpp"
+#endif
+
+#include "mednafen/file.cpp"
+#include "mednafen/md5.cpp"
@@ -0,0 +1,388 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ psxbench: runs the core headless, as fast as the host allows, and reports the speed and where the time went.
+
+	Usage: psxbench [-b bios_dir] [-s save_dir] [-m movie] [-n frames] [-o option=value]... [-j counters.json] [-v] image
+
+ -b is the system directory holding the BIOS(scph5500.bin/scph5501.bin/scph5502.bin; default ".") and -s the save
+ directory for memory cards(default: the system directory).  -m replays an input movie(see libretro_psx_ext.h) from its
+ start, otherwise no buttons are pressed.  -n is the number of frames to run(default: the movie's length, or 3600).
+ -o sets a core option(e.g. -o beetle_psx_run_ahead=1), -v shows the core's informational messages.
+
+ -j writes the hot-path counters(retro_psx_get_counters()) to a JSON file: their totals, with the GPU commands by opcode,
+ and every frame's, with the GPU commands summed.
+
+ The core is built with PSX_PROFILE(mednafen/psx/profile.h), so besides frames per second it reports the host time spent
+ in the CPU, GPU, SPU, CDC and MDEC, and the peak resident set size.  The profiling costs a little speed, so compare
+ psxbench results with each other rather than with a frontend.
+*/
+
+#include "libretro.h"
+#include "libretro_psx_ext.h"
+#include "mednafen/mednafen-types.h"
+#include "mednafen/psx/profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+static std::string system_dir = ".";
+static std::string save_dir;
+static std::vector<std::string> option_keys;
+static std::vector<std::string> option_values;
+static bool verbose = false;
+
+static void bench_log(enum retro_log_level level, const char *fmt, ...)
+{
+   va_list ap;
+
+   if (level < (verbose ? RETRO_LOG_INFO : RETRO_LOG_WARN))
+      return;
+
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+static bool bench_environment(unsigned cmd, void *data)
+{
+   switch (cmd)
+   {
+      case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+         ((struct retro_log_callback*)data)->log = bench_log;
+         return true;
+
+      case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+         *(const char**)data = system_dir.c_str();
+         return true;
+
+      case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY:
+         *(const char**)data = save_dir.c_str();
+         return true;
+
+      case RETRO_ENVIRONMENT_GET_VARIABLE:
+      {
+         struct retro_variable *var = (struct retro_variable*)data;
+
+         for (unsigned i = 0; i < option_keys.size(); i++)
+         {
+            if (option_keys[i] == var->key)
+            {
+               var->value = option_values[i].c_str();
+               return true;
+            }
+         }
+         return false;
+      }
+
+      case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+         return true;
+
+      default:
+         return false;
+   }
+}
+
+static void bench_video(const void *data, unsigned width, unsigned height, size_t pitch)
+{
+}
+
+static void bench_audio(int16_t left, int16_t right)
+{
+}
+
+static size_t bench_audio_batch(const int16_t *data, size_t frames)
+{
+   return frames;
+}
+
+static void bench_input_poll(void)
+{
+}
+
+static int16_t bench_input_state(unsigned port, unsigned device, unsigned index, unsigned id)
+{
+   return 0;
+}
+
+// In KiB, or 0 where unavailable.
+static unsigned long PeakRSS(void)
+{
+#if defined(_WIN32)
+   return 0;
+#else
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage))
+      return 0;
+#if defined(__APPLE__)
+   return usage.ru_maxrss / 1024;
+#else
+   return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Counters of a frame, without the GPU opcode breakdown to keep the per-frame history(and its effect on the peak RSS)
+// small.
+struct FrameCounters
+{
+   uint64 cpu_instructions, cpu_icache_misses, gpu_commands, gpu_pixels, dma_words[7];
+   uint64 spu_samples, spu_voice_samples, cd_sectors, cd_xa_sectors;
+   uint64 events_gpu, events_cdc, events_timer, events_dma, events_fio;
+};
+
+static FrameCounters Summarize(const struct retro_psx_counters *c)
+{
+   FrameCounters fc;
+
+   fc.cpu_instructions = c->cpu_instructions;
+   fc.cpu_icache_misses = c->cpu_icache_misses;
+   fc.gpu_commands = 0;
+   for (unsigned i = 0; i < 256; i++)
+      fc.gpu_commands += c->gpu_commands[i];
+   fc.gpu_pixels = c->gpu_pixels;
+   for (unsigned i = 0; i < 7; i++)
+      fc.dma_words[i] = c->dma_words[i];
+   fc.spu_samples = c->spu_samples;
+   fc.spu_voice_samples = c->spu_voice_samples;
+   fc.cd_sectors = c->cd_sectors;
+   fc.cd_xa_sectors = c->cd_xa_sectors;
+   fc.events_gpu = c->events_gpu;
+   fc.events_cdc = c->events_cdc;
+   fc.events_timer = c->events_timer;
+   fc.events_dma = c->events_dma;
+   fc.events_fio = c->events_fio;
+
+   return fc;
+}
+
+static void AddCounters(struct retro_psx_counters *total, const struct retro_psx_counters *c)
+{
+   uint64_t *t = (uint64_t*)total;
+   const uint64_t *f = (const uint64_t*)c;
+
+   // All members are uint64_t.
+   for (unsigned i = 0; i < sizeof(*c) / sizeof(uint64_t); i++)
+      t[i] += f[i];
+}
+
+// by_opcode, if not NULL, replaces the GPU command count with counts by opcode.
+static void WriteCounters(FILE *fp, const FrameCounters *c, const uint64_t *by_opcode)
+{
+   fprintf(fp, "{\"cpu_instructions\":%llu,\"cpu_icache_misses\":%llu,", (unsigned long long)c->cpu_instructions,
+           (unsigned long long)c->cpu_icache_misses);
+
+   if (by_opcode)
+   {
+      bool first = true;
+
+      fprintf(fp, "\"gpu_commands\":{");
+      for (unsigned i = 0; i < 256; i++)
+      {
+         if (!by_opcode[i])
+            continue;
+         fprintf(fp, "%s\"0x%02x\":%llu", first ? "" : ",", i, (unsigned long long)by_opcode[i]);
+         first = false;
+      }
+      fprintf(fp, "},");
+   }
+   else
+      fprintf(fp, "\"gpu_commands\":%llu,", (unsigned long long)c->gpu_commands);
+
+   fprintf(fp, "\"gpu_pixels\":%llu,\"dma_words\":[", (unsigned long long)c->gpu_pixels);
+   for (unsigned i = 0; i < 7; i++)
+      fprintf(fp, "%s%llu", i ? "," : "", (unsigned long long)c->dma_words[i]);
+
+   fprintf(fp, "],\"spu_samples\":%llu,\"spu_voice_samples\":%llu,\"cd_sectors\":%llu,\"cd_xa_sectors\":%llu,",
+           (unsigned long long)c->spu_samples, (unsigned long long)c->spu_voice_samples,
+           (unsigned long long)c->cd_sectors, (unsigned long long)c->cd_xa_sectors);
+
+   fprintf(fp, "\"events\":{\"gpu\":%llu,\"cdc\":%llu,\"timer\":%llu,\"dma\":%llu,\"fio\":%llu}}",
+           (unsigned long long)c->events_gpu, (unsigned long long)c->events_cdc, (unsigned long long)c->events_timer,
+           (unsigned long long)c->events_dma, (unsigned long long)c->events_fio);
+}
+
+int main(int argc, char *argv[])
+{
+   static const char *section_names[PSX_PROF_COUNT] = { "other", "cpu", "gpu", "spu", "cdc", "mdec" };
+   const char *movie_path = NULL;
+   const char *counters_path = NULL;
+   struct retro_psx_counters counters, counters_total;
+   std::vector<FrameCounters> frame_counters;
+   uint64 frames = 0;
+   uint64 ns[PSX_PROF_COUNT];
+   uint64 total_ns = 0;
+   struct retro_game_info game;
+   struct retro_system_av_info av_info;
+   struct retro_psx_movie_status movie_status;
+   uint64 frame;
+   int i;
+
+   for (i = 1; i < argc && argv[i][0] == '-'; i++)
+   {
+      if (!strcmp(argv[i], "-b") && (i + 1) < argc)
+         system_dir = argv[++i];
+      else if (!strcmp(argv[i], "-s") && (i + 1) < argc)
+         save_dir = argv[++i];
+      else if (!strcmp(argv[i], "-m") && (i + 1) < argc)
+         movie_path = argv[++i];
+      else if (!strcmp(argv[i], "-n") && (i + 1) < argc)
+         frames = strtoull(argv[++i], NULL, 10);
+      else if (!strcmp(argv[i], "-o") && (i + 1) < argc && strchr(argv[i + 1], '='))
+      {
+         const char *option = argv[++i];
+         const char *eq = strchr(option, '=');
+
+         option_keys.push_back(std::string(option, eq - option));
+         option_values.push_back(std::string(eq + 1));
+      }
+      else if (!strcmp(argv[i], "-j") && (i + 1) < argc)
+         counters_path = argv[++i];
+      else if (!strcmp(argv[i], "-v"))
+         verbose = true;
+      else
+         break;
+   }
+
+   if ((i + 1) != argc)
+   {
+      fprintf(stderr, "Usage: %s [-b bios_dir] [-s save_dir] [-m movie] [-n frames] [-o option=value]... [-j counters.json] [-v] image\n", argv[0]);
+      return 2;
+   }
+
+   retro_set_environment(bench_environment);
+   retro_set_video_refresh(bench_video);
+   retro_set_audio_sample(bench_audio);
+   retro_set_audio_sample_batch(bench_audio_batch);
+   retro_set_input_poll(bench_input_poll);
+   retro_set_input_state(bench_input_state);
+   retro_init();
+
+   memset(&game, 0, sizeof(game));
+   game.path = argv[i];
+
+   if (!retro_load_game(&game))
+   {
+      fprintf(stderr, "Error loading \"%s\".\n", argv[i]);
+      retro_deinit();
+      return 2;
+   }
+
+   if (movie_path)
+   {
+      if (!retro_psx_movie_play(movie_path))
+      {
+         fprintf(stderr, "Error playing movie \"%s\".\n", movie_path);
+         retro_unload_game();
+         retro_deinit();
+         return 2;
+      }
+
+      retro_psx_movie_get_status(&movie_status);
+
+      if (!frames)
+         frames = movie_status.length;
+   }
+
+   if (!frames)
+      frames = 3600;
+
+   retro_get_system_av_info(&av_info);
+
+   memset(&counters_total, 0, sizeof(counters_total));
+   if (counters_path)
+      frame_counters.reserve(frames);
+
+   PSX_ProfReset();
+
+   for (frame = 0; frame < frames; frame++)
+   {
+      retro_run();
+
+      if (counters_path)
+      {
+         retro_psx_get_counters(&counters);
+         AddCounters(&counters_total, &counters);
+         frame_counters.push_back(Summarize(&counters));
+      }
+   }
+
+   PSX_ProfGet(ns);
+
+   for (unsigned s = 0; s < PSX_PROF_COUNT; s++)
+      total_ns += ns[s];
+
+   if (movie_path)
+   {
+      retro_psx_movie_get_status(&movie_status);
+
+      if (movie_status.mode != RETRO_PSX_MOVIE_PLAYING && movie_status.frame < frames)
+         printf("Movie ended after %llu frames.\n", (unsigned long long)movie_status.frame);
+   }
+
+   printf("%llu frames in %.3f s: %.1f fps, %.3f ms/frame, %.2fx real time\n", (unsigned long long)frames, total_ns / 1e9,
+          frames * 1e9 / total_ns, total_ns / 1e6 / frames, frames * 1e9 / total_ns / av_info.timing.fps);
+
+   for (unsigned s = 0; s < PSX_PROF_COUNT; s++)
+   {
+      printf("  %-6s %9.3f s %6.1f%% %8.3f ms/frame\n", section_names[s], ns[s] / 1e9, ns[s] * 100.0 / total_ns,
+             ns[s] / 1e6 / frames);
+   }
+
+   if (PeakRSS())
+      printf("Peak RSS: %lu KiB\n", PeakRSS());
+
+   if (counters_path)
+   {
+      FILE *fp = fopen(counters_path, "w");
+
+      if (!fp)
+         fprintf(stderr, "Error opening \"%s\" for writing.\n", counters_path);
+      else
+      {
+         const FrameCounters total = Summarize(&counters_total);
+
+         fprintf(fp, "{\"frames\":%llu,\"total\":", (unsigned long long)frames);
+         WriteCounters(fp, &total, counters_total.gpu_commands);
+         fprintf(fp, ",\n\"per_frame\":[\n");
+
+         for (size_t f = 0; f < frame_counters.size(); f++)
+         {
+            WriteCounters(fp, &frame_counters[f], NULL);
+            fprintf(fp, f + 1 < frame_counters.size() ? ",\n" : "\n");
+         }
+
+         fprintf(fp, "]}\n");
+         fclose(fp);
+      }
+   }
+
+   retro_unload_game();
+   retro_deinit();
+
+   return 0;
+}